@@ -0,0 +1,82 @@
+#include "datagui/datapack/reader.hpp"
+#include "datagui/datapack/writer.hpp"
+#include <benchmark/benchmark.h>
+#include <datapack/std/optional.hpp>
+#include <datapack/std/string.hpp>
+#include <datapack/std/vector.hpp>
+
+struct Item {
+  std::string name;
+  int count;
+  double weight;
+  bool enabled;
+  std::optional<double> limit;
+};
+
+struct Inventory {
+  std::string title;
+  std::vector<Item> items;
+  std::vector<double> values;
+};
+
+namespace dpack {
+DPACK_INLINE(Item, name, count, weight, enabled, limit)
+DPACK_INLINE(Inventory, title, items, values)
+} // namespace dpack
+
+using namespace dgui;
+
+static Inventory make_inventory(std::size_t n) {
+  Inventory inventory;
+  inventory.title = "inventory";
+  for (std::size_t i = 0; i < n; i++) {
+    Item item;
+    item.name = "item " + std::to_string(i);
+    item.count = i;
+    item.weight = i * 0.5;
+    item.enabled = i % 2 == 0;
+    if (i % 3 == 0) {
+      item.limit = i;
+    }
+    inventory.items.push_back(item);
+    inventory.values.push_back(i);
+  }
+  return inventory;
+}
+
+static void BM_GuiWriter(benchmark::State& bench) {
+  Inventory inventory = make_inventory(bench.range(0));
+  Tree tree;
+  auto root = tree.root();
+  root.create(Type::Group);
+
+  for (auto _ : bench) {
+    ElementPtr node = root.child();
+    GuiWriter writer(node, "inventory");
+    writer.value(inventory);
+  }
+  bench.SetItemsProcessed(bench.iterations() * bench.range(0));
+}
+BENCHMARK(BM_GuiWriter)->Arg(10)->Arg(500);
+
+static void BM_GuiWriterReader(benchmark::State& bench) {
+  Inventory inventory = make_inventory(bench.range(0));
+  Tree tree;
+  auto root = tree.root();
+  root.create(Type::Group);
+
+  for (auto _ : bench) {
+    {
+      ElementPtr node = root.child();
+      GuiWriter writer(node, "inventory");
+      writer.value(inventory);
+    }
+    {
+      ElementPtr node = root.child();
+      GuiReader reader(node, "inventory");
+      reader.value(inventory);
+    }
+  }
+  bench.SetItemsProcessed(bench.iterations() * bench.range(0));
+}
+BENCHMARK(BM_GuiWriterReader)->Arg(10)->Arg(500);
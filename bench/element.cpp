@@ -0,0 +1,201 @@
+#include "datagui/element/key_list.hpp"
+#include "datagui/element/tree.hpp"
+#include "datagui/element/vector_map.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <string>
+
+using namespace dgui;
+
+static void BM_VectorMapEmplacePop(benchmark::State& bench) {
+  const std::size_t n = bench.range(0);
+  VectorMap<std::string> map;
+  std::vector<int> indices(n);
+  for (auto _ : bench) {
+    for (std::size_t i = 0; i < n; i++) {
+      indices[i] = map.emplace("element");
+    }
+    for (std::size_t i = 0; i < n; i += 2) {
+      map.pop(indices[i]);
+    }
+    for (std::size_t i = 1; i < n; i += 2) {
+      map.pop(indices[i]);
+    }
+  }
+  bench.SetItemsProcessed(bench.iterations() * n);
+}
+BENCHMARK(BM_VectorMapEmplacePop)->Arg(1000)->Arg(100000);
+
+static void BM_VectorMapIterate(benchmark::State& bench) {
+  const std::size_t n = bench.range(0);
+  VectorMap<int> map;
+  for (std::size_t i = 0; i < n; i++) {
+    map.emplace(i);
+  }
+  // Leave every 4th slot empty, as after elements are removed
+  for (std::size_t i = 0; i < n; i += 4) {
+    map.pop(i);
+  }
+  for (auto _ : bench) {
+    long sum = 0;
+    for (int value : map) {
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  bench.SetItemsProcessed(bench.iterations() * map.size());
+}
+BENCHMARK(BM_VectorMapIterate)->Arg(1000)->Arg(100000);
+
+// Insert and remove in the middle of a list, as when editing a list variable
+static void BM_KeyListInsertRemove(benchmark::State& bench) {
+  const std::size_t n = bench.range(0);
+  KeyList keys;
+  for (std::size_t i = 0; i < n; i++) {
+    keys.append();
+  }
+  for (auto _ : bench) {
+    std::size_t key = keys.insert(n / 2);
+    keys.remove(keys[n / 3]);
+    benchmark::DoNotOptimize(key);
+  }
+  bench.SetItemsProcessed(bench.iterations());
+}
+BENCHMARK(BM_KeyListInsertRemove)->Arg(1000)->Arg(100000);
+
+static void BM_TreeCreateRemove(benchmark::State& bench) {
+  const std::size_t n = bench.range(0);
+  Tree tree;
+  auto root = tree.root();
+  root.create(Type::Group);
+
+  for (auto _ : bench) {
+    auto element = root.child();
+    for (std::size_t i = 0; i < n; i++) {
+      element.create(Type::TextBox);
+      element = element.next();
+    }
+    root.clear();
+  }
+  bench.SetItemsProcessed(bench.iterations() * n);
+}
+BENCHMARK(BM_TreeCreateRemove)->Arg(100)->Arg(10000);
+
+// Rebuild a list of keyed elements each iteration, with the last element
+// moved to the front, as when a keyed list is reordered
+static void BM_ElementExpectReorder(benchmark::State& bench) {
+  const std::size_t n = bench.range(0);
+  Tree tree;
+  auto root = tree.root();
+  root.create(Type::Group);
+
+  std::vector<std::size_t> ids(n);
+  for (std::size_t i = 0; i < n; i++) {
+    ids[i] = i + 1;
+  }
+
+  for (auto _ : bench) {
+    std::rotate(ids.rbegin(), ids.rbegin() + 1, ids.rend());
+    auto element = root.child();
+    for (std::size_t id : ids) {
+      element.expect(Type::TextBox, id);
+      element = element.next();
+    }
+    element.expect_end();
+  }
+  bench.SetItemsProcessed(bench.iterations() * n);
+}
+BENCHMARK(BM_ElementExpectReorder)->Arg(100)->Arg(1000);
+
+// Rebuild with the same ids each iteration, the common case
+static void BM_ElementExpectStable(benchmark::State& bench) {
+  const std::size_t n = bench.range(0);
+  Tree tree;
+  auto root = tree.root();
+  root.create(Type::Group);
+
+  for (auto _ : bench) {
+    auto element = root.child();
+    for (std::size_t i = 0; i < n; i++) {
+      element.expect(Type::TextBox, i + 1);
+      element = element.next();
+    }
+    element.expect_end();
+  }
+  bench.SetItemsProcessed(bench.iterations() * n);
+}
+BENCHMARK(BM_ElementExpectStable)->Arg(100)->Arg(10000);
+
+// Access every variable of an element, as gui.variable<T>() does each frame
+static void BM_VariableAccess(benchmark::State& bench) {
+  const std::size_t n = bench.range(0);
+  Tree tree;
+  auto root = tree.root();
+  root.create(Type::Group);
+
+  auto var = root.var();
+  for (std::size_t i = 0; i < n; i++) {
+    var.create<int>(i);
+    var = var.next();
+  }
+
+  for (auto _ : bench) {
+    long sum = 0;
+    auto var = root.var();
+    while (var) {
+      sum += *var.as<int>();
+      var = var.next();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  bench.SetItemsProcessed(bench.iterations() * n);
+}
+BENCHMARK(BM_VariableAccess)->Arg(1000)->Arg(100000);
+
+// Depth-first pass over a tree of 50k elements reading the layout fields, as
+// calculate_sizes() and render() do each frame
+static void BM_TreeTraversal(benchmark::State& bench) {
+  const std::size_t n = 50000;
+  const std::size_t width = bench.range(0);
+  Tree tree;
+  auto root = tree.root();
+  root.create(Type::Group);
+
+  std::vector<ElementPtr> parents = {root};
+  std::size_t count = 1;
+  while (count < n) {
+    std::vector<ElementPtr> next_parents;
+    for (auto parent : parents) {
+      auto element = parent.child();
+      for (std::size_t i = 0; i < width && count < n; i++) {
+        element.create(Type::Group);
+        element.state().fixed_size = Vec2(i, i);
+        next_parents.push_back(element);
+        element = element.next();
+        count++;
+      }
+    }
+    parents = std::move(next_parents);
+  }
+
+  std::vector<ElementPtr> stack;
+  for (auto _ : bench) {
+    Vec2 sum;
+    stack.push_back(tree.root());
+    while (!stack.empty()) {
+      auto element = stack.back();
+      stack.pop_back();
+      const auto& state = element.state();
+      if (state.hidden) {
+        continue;
+      }
+      sum += state.fixed_size + state.dynamic_size;
+      for (auto child = element.child(); child; child = child.next()) {
+        stack.push_back(child);
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  bench.SetItemsProcessed(bench.iterations() * n);
+}
+BENCHMARK(BM_TreeTraversal)->Arg(4)->Arg(64);
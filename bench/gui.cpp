@@ -0,0 +1,356 @@
+#include "datagui/gui.hpp"
+#include <benchmark/benchmark.h>
+
+using namespace dgui;
+
+// Returns false, skipping the benchmark, if the window can't be opened
+static bool open_headless(Gui& gui, benchmark::State& bench) {
+  try {
+    gui.open("bench", 900, 600, WindowMode::Headless);
+  } catch (const std::runtime_error&) {
+    bench.SkipWithError("Failed to open headless window");
+    return false;
+  }
+  return true;
+}
+
+// A large static tree, where one text box changes each frame. Times only the
+// layout phase, which should scale with the changed subtree rather than the
+// whole tree.
+static void BM_GuiLayoutOneChange(benchmark::State& bench) {
+  const std::size_t n = bench.range(0);
+
+  Gui gui;
+  if (!open_headless(gui, bench)) {
+    return;
+  }
+
+  std::size_t frame = 0;
+  std::size_t laid_out = 0;
+  std::size_t positioned = 0;
+  for (auto _ : bench) {
+    if (!gui.poll()) {
+      bench.SkipWithError("Window closed");
+      return;
+    }
+    gui.group();
+    {
+      DGUI_SCOPE(gui);
+      for (std::size_t i = 0; i < n; i++) {
+        gui.args().horizontal();
+        gui.group();
+        DGUI_SCOPE(gui);
+        gui.text_box("Row " + std::to_string(i));
+        if (i == n / 2) {
+          gui.text_box(std::to_string(frame));
+        } else {
+          gui.text_box("Static");
+        }
+      }
+    }
+    frame++;
+
+    // Timings and counters of the frame finished by poll()
+    const auto& stats = gui.frame_stats();
+    bench.SetIterationTime(stats.timing(FramePhase::Layout).last);
+    laid_out += stats.counters().elements_laid_out;
+    positioned += stats.counters().elements_positioned;
+  }
+  bench.counters["laid_out"] =
+      benchmark::Counter(laid_out, benchmark::Counter::kAvgIterations);
+  bench.counters["positioned"] =
+      benchmark::Counter(positioned, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_GuiLayoutOneChange)->UseManualTime()->Arg(1000)->Arg(10000);
+
+// Columns of text boxes which all change each frame, so every element is
+// measured, with the layout split over the given number of threads
+static void BM_GuiLayoutParallel(benchmark::State& bench) {
+  const std::size_t threads = bench.range(0);
+  const std::size_t columns = 8;
+  const std::size_t rows = 500;
+
+  Gui gui;
+  if (!open_headless(gui, bench)) {
+    return;
+  }
+  gui.parallel_layout(threads);
+
+  std::size_t frame = 0;
+  for (auto _ : bench) {
+    if (!gui.poll()) {
+      bench.SkipWithError("Window closed");
+      return;
+    }
+    gui.args().horizontal();
+    gui.group();
+    {
+      DGUI_SCOPE(gui);
+      for (std::size_t i = 0; i < columns; i++) {
+        gui.group();
+        DGUI_SCOPE(gui);
+        for (std::size_t j = 0; j < rows; j++) {
+          gui.text_box(std::to_string(frame * rows + j));
+        }
+      }
+    }
+    frame++;
+
+    const auto& stats = gui.frame_stats();
+    bench.SetIterationTime(stats.timing(FramePhase::Layout).last);
+  }
+}
+BENCHMARK(BM_GuiLayoutParallel)->UseManualTime()->Arg(1)->Arg(4);
+
+// A large static tree, with the mouse moving each frame. Times the event
+// handling phase, which is dominated by finding the element under the mouse.
+static void BM_GuiHover(benchmark::State& bench) {
+  const std::size_t n = bench.range(0);
+
+  Gui gui;
+  if (!open_headless(gui, bench)) {
+    return;
+  }
+
+  std::size_t frame = 0;
+  for (auto _ : bench) {
+    gui.window().inject_mouse_pos(Vec2(frame % 900, (frame * 7) % 600));
+    if (!gui.poll()) {
+      bench.SkipWithError("Window closed");
+      return;
+    }
+    gui.group();
+    {
+      DGUI_SCOPE(gui);
+      for (std::size_t i = 0; i < n; i++) {
+        gui.text_box("Row " + std::to_string(i));
+      }
+    }
+    frame++;
+
+    const auto& stats = gui.frame_stats();
+    bench.SetIterationTime(stats.timing(FramePhase::Events).last);
+  }
+}
+BENCHMARK(BM_GuiHover)
+    ->UseManualTime()
+    ->Iterations(200)
+    ->Arg(1000)
+    ->Arg(20000);
+
+// A long scrolling panel, of which only a few rows are visible. Times the
+// render phase, which should scale with the visible rows.
+static void BM_GuiRenderScroll(benchmark::State& bench) {
+  const std::size_t n = bench.range(0);
+
+  Gui gui;
+  if (!open_headless(gui, bench)) {
+    return;
+  }
+
+  std::size_t culled = 0;
+  for (auto _ : bench) {
+    if (!gui.poll()) {
+      bench.SkipWithError("Window closed");
+      return;
+    }
+    gui.args().height_fixed(400);
+    gui.group();
+    {
+      DGUI_SCOPE(gui);
+      for (std::size_t i = 0; i < n; i++) {
+        gui.text_box("Row " + std::to_string(i));
+      }
+    }
+
+    const auto& stats = gui.frame_stats();
+    bench.SetIterationTime(stats.timing(FramePhase::Render).last);
+    culled += stats.counters().elements_culled;
+  }
+  bench.counters["culled"] =
+      benchmark::Counter(culled, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_GuiRenderScroll)
+    ->UseManualTime()
+    ->Iterations(200)
+    ->Arg(1000)
+    ->Arg(20000);
+
+// Many visible elements, redrawn each frame. Times the flushes, which upload
+// the queued vertices and draw them.
+static void BM_GuiFlush(benchmark::State& bench) {
+  const std::size_t rows = bench.range(0);
+  const std::size_t columns = 8;
+
+  Gui gui;
+  if (!open_headless(gui, bench)) {
+    return;
+  }
+
+  std::size_t draw_calls = 0;
+  std::size_t bytes_uploaded = 0;
+  std::size_t buffer_allocations = 0;
+  for (auto _ : bench) {
+    if (!gui.poll()) {
+      bench.SkipWithError("Window closed");
+      return;
+    }
+    gui.args().horizontal();
+    gui.group();
+    {
+      DGUI_SCOPE(gui);
+      for (std::size_t i = 0; i < columns; i++) {
+        gui.group();
+        DGUI_SCOPE(gui);
+        for (std::size_t j = 0; j < rows; j++) {
+          std::ignore = gui.button(std::to_string(i * rows + j));
+        }
+      }
+    }
+
+    const auto& stats = gui.frame_stats();
+    bench.SetIterationTime(stats.timing(FramePhase::Flush).last);
+    draw_calls += stats.counters().draw_calls;
+    bytes_uploaded += stats.counters().bytes_uploaded;
+    buffer_allocations += stats.counters().buffer_allocations;
+  }
+  bench.counters["draw_calls"] =
+      benchmark::Counter(draw_calls, benchmark::Counter::kAvgIterations);
+  bench.counters["bytes_uploaded"] =
+      benchmark::Counter(bytes_uploaded, benchmark::Counter::kAvgIterations);
+  bench.counters["buffer_allocations"] = benchmark::Counter(
+      buffer_allocations,
+      benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_GuiFlush)->UseManualTime()->Iterations(500)->Arg(4)->Arg(20);
+
+// A panel of visible elements, of which only a counter changes, if enabled.
+// Times rendering and flushing, which only re-render and redraw what
+// changed.
+static void BM_GuiRenderRetained(benchmark::State& bench) {
+  const std::size_t rows = bench.range(0);
+  const bool ticking = bench.range(1);
+  const std::size_t columns = 8;
+
+  Gui gui;
+  if (!open_headless(gui, bench)) {
+    return;
+  }
+
+  std::size_t frame = 0;
+  std::size_t elements_reused = 0;
+  std::size_t layers_reused = 0;
+  std::size_t bytes_uploaded = 0;
+  double damaged_fraction = 0;
+  for (auto _ : bench) {
+    if (!gui.poll()) {
+      bench.SkipWithError("Window closed");
+      return;
+    }
+    gui.group();
+    {
+      DGUI_SCOPE(gui);
+      gui.text_box(std::to_string(ticking ? frame : 0));
+      gui.args().horizontal();
+      gui.group();
+      {
+        DGUI_SCOPE(gui);
+        for (std::size_t i = 0; i < columns; i++) {
+          gui.group();
+          DGUI_SCOPE(gui);
+          for (std::size_t j = 0; j < rows; j++) {
+            std::ignore = gui.button(std::to_string(i * rows + j));
+          }
+        }
+      }
+    }
+    frame++;
+
+    const auto& stats = gui.frame_stats();
+    bench.SetIterationTime(
+        stats.timing(FramePhase::Render).last +
+        stats.timing(FramePhase::Flush).last);
+    elements_reused += stats.counters().elements_reused;
+    layers_reused += stats.counters().layers_reused;
+    bytes_uploaded += stats.counters().bytes_uploaded;
+    damaged_fraction += stats.counters().damaged_fraction;
+  }
+  bench.counters["elements_reused"] =
+      benchmark::Counter(elements_reused, benchmark::Counter::kAvgIterations);
+  bench.counters["layers_reused"] =
+      benchmark::Counter(layers_reused, benchmark::Counter::kAvgIterations);
+  bench.counters["bytes_uploaded"] =
+      benchmark::Counter(bytes_uploaded, benchmark::Counter::kAvgIterations);
+  bench.counters["damaged_fraction"] =
+      benchmark::Counter(damaged_fraction, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_GuiRenderRetained)
+    ->UseManualTime()
+    ->Iterations(500)
+    ->Args({20, 0})
+    ->Args({20, 1});
+
+// A static panel next to a counter which changes every frame, drawn with or
+// without caching the panel
+static void BM_GuiRenderCached(benchmark::State& bench) {
+  const std::size_t rows = bench.range(0);
+  const bool cached = bench.range(1);
+  const std::size_t columns = 8;
+
+  Gui gui;
+  if (!open_headless(gui, bench)) {
+    return;
+  }
+
+  std::size_t frame = 0;
+  std::size_t elements_rendered = 0;
+  std::size_t cached_groups_rendered = 0;
+  std::size_t cache_memory = 0;
+  for (auto _ : bench) {
+    if (!gui.poll()) {
+      bench.SkipWithError("Window closed");
+      return;
+    }
+    gui.args().horizontal();
+    gui.group();
+    {
+      DGUI_SCOPE(gui);
+      gui.text_box(std::to_string(frame));
+      if (cached) {
+        gui.args().cached();
+      }
+      gui.args().horizontal();
+      gui.group();
+      {
+        DGUI_SCOPE(gui);
+        for (std::size_t i = 0; i < columns; i++) {
+          gui.group();
+          DGUI_SCOPE(gui);
+          for (std::size_t j = 0; j < rows; j++) {
+            gui.text_box(std::to_string(i * rows + j));
+          }
+        }
+      }
+    }
+    frame++;
+
+    const auto& stats = gui.frame_stats();
+    bench.SetIterationTime(
+        stats.timing(FramePhase::Render).last +
+        stats.timing(FramePhase::Flush).last);
+    elements_rendered += stats.counters().elements_rendered;
+    cached_groups_rendered += stats.counters().cached_groups_rendered;
+    cache_memory = stats.counters().cache_memory;
+  }
+  bench.counters["elements_rendered"] =
+      benchmark::Counter(elements_rendered, benchmark::Counter::kAvgIterations);
+  bench.counters["cached_groups_rendered"] = benchmark::Counter(
+      cached_groups_rendered,
+      benchmark::Counter::kAvgIterations);
+  bench.counters["cache_memory"] = cache_memory;
+}
+BENCHMARK(BM_GuiRenderCached)
+    ->UseManualTime()
+    ->Iterations(500)
+    ->Args({20, 0})
+    ->Args({20, 1});
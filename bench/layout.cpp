@@ -0,0 +1,41 @@
+#include "datagui/system_utils/layout.hpp"
+#include <benchmark/benchmark.h>
+
+using namespace dgui;
+
+static void BM_LayoutSetInputState(benchmark::State& bench) {
+  const std::size_t n = bench.range(0);
+  const int cols = bench.range(1);
+  auto theme = std::make_shared<Theme>(theme_default());
+
+  Tree tree;
+  auto root = tree.root();
+  root.create(Type::Group);
+  root.group().layout.cols = cols;
+
+  auto element = root.child();
+  for (std::size_t i = 0; i < n; i++) {
+    element.create(Type::TextBox);
+    element.state().fixed_size = Vec2(100 + i % 7, 20);
+    element.state().dynamic_size = Vec2(i % 3 == 0 ? 1 : 0, 0);
+    element = element.next();
+  }
+
+  FrameArena arena;
+  auto& group = root.group();
+  for (auto _ : bench) {
+    arena.reset();
+    layout_set_input_state(
+        root,
+        theme,
+        arena,
+        group.layout,
+        group.layout_state);
+    benchmark::DoNotOptimize(group.layout_state.content_fixed_size);
+  }
+  bench.SetItemsProcessed(bench.iterations() * n);
+}
+BENCHMARK(BM_LayoutSetInputState)
+    ->Args({100, 1})
+    ->Args({10000, 1})
+    ->Args({10000, 4});
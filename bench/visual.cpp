@@ -0,0 +1,156 @@
+#include "datagui/visual/font_manager.hpp"
+#include "datagui/visual/shape_2d_shader.hpp"
+#include "datagui/visual/text_2d_shader.hpp"
+#include "datagui/visual/window.hpp"
+#include <benchmark/benchmark.h>
+
+using namespace dgui;
+
+// Font textures are created on first use, so require a GL context
+static bool open_window() {
+  static Window window;
+  static bool opened = false;
+  static bool failed = false;
+  if (!opened && !failed) {
+    try {
+      window.open("bench", 100, 100, WindowMode::Headless);
+      opened = true;
+    } catch (const std::runtime_error&) {
+      failed = true;
+    }
+  }
+  return opened;
+}
+
+static const std::string paragraph =
+    "The quick brown fox jumps over the lazy dog. Pack my box with five "
+    "dozen liquor jugs. How vexingly quick daft zebras jump!";
+
+static void BM_FontManagerTextSize(benchmark::State& bench) {
+  if (!open_window()) {
+    bench.SkipWithError("Failed to open headless window");
+    return;
+  }
+  // Second argument enables the text cache
+  FontManager fm;
+  if (!bench.range(1)) {
+    fm.set_text_cache_capacity(0);
+  }
+  Length width = bench.range(0) == 0 ? Length(LengthWrap())
+                                     : Length(LengthFixed(bench.range(0)));
+  fm.text_size(paragraph, Font::DejaVuSans, 16, width);
+
+  for (auto _ : bench) {
+    benchmark::DoNotOptimize(
+        fm.text_size(paragraph, Font::DejaVuSans, 16, width));
+  }
+  bench.SetItemsProcessed(bench.iterations() * paragraph.size());
+}
+BENCHMARK(BM_FontManagerTextSize)
+    ->Args({0, 0})
+    ->Args({0, 1})
+    ->Args({200, 0})
+    ->Args({200, 1});
+
+static void BM_FontManagerTextCharacters(benchmark::State& bench) {
+  if (!open_window()) {
+    bench.SkipWithError("Failed to open headless window");
+    return;
+  }
+  // Second argument enables the text cache
+  FontManager fm;
+  if (!bench.range(1)) {
+    fm.set_text_cache_capacity(0);
+  }
+  Length width = bench.range(0) == 0 ? Length(LengthWrap())
+                                     : Length(LengthFixed(bench.range(0)));
+  fm.text_characters(paragraph, Font::DejaVuSans, 16, width);
+
+  for (auto _ : bench) {
+    benchmark::DoNotOptimize(
+        fm.text_characters(paragraph, Font::DejaVuSans, 16, width));
+  }
+  bench.SetItemsProcessed(bench.iterations() * paragraph.size());
+}
+BENCHMARK(BM_FontManagerTextCharacters)
+    ->Args({0, 0})
+    ->Args({0, 1})
+    ->Args({200, 0})
+    ->Args({200, 1});
+
+// Only queues instances, which doesn't require a GL context
+static void BM_Shape2dShaderQueue(benchmark::State& bench) {
+  const std::size_t n = bench.range(0);
+  Shape2dShader shader;
+  Box2 mask(Vec2(0, 0), Vec2(800, 600));
+
+  for (auto _ : bench) {
+    for (std::size_t i = 0; i < n; i++) {
+      Vec2 position(i % 800, i % 600);
+      switch (i % 4) {
+      case 0:
+        shader.queue_masked_box(
+            mask,
+            Box2(position, position + Vec2(40, 20)),
+            Color::Red(),
+            1,
+            Color::Black(),
+            4);
+        break;
+      case 1:
+        shader.queue_rect(position, 0.5, Vec2(40, 20), Color::Green());
+        break;
+      case 2:
+        shader.queue_circle(position, 10, Color::Blue(), 1);
+        break;
+      case 3:
+        shader.queue_line(position, position + Vec2(30, 30), 2, Color::Black());
+        break;
+      }
+    }
+    shader.clear();
+  }
+  bench.SetItemsProcessed(bench.iterations() * n);
+}
+BENCHMARK(BM_Shape2dShaderQueue)->Arg(1000)->Arg(100000);
+
+// Lines of text in several colors, queued and drawn each iteration
+static void BM_Text2dShaderDraw(benchmark::State& bench) {
+  if (!open_window()) {
+    bench.SkipWithError("Failed to open headless window");
+    return;
+  }
+  const std::size_t lines = bench.range(0);
+  const Color colors[] = {Color::Black(), Color::Red(), Color::Blue()};
+
+  auto fm = std::make_shared<FontManager>();
+  Text2dShader shader;
+  shader.init(fm);
+  Box2 viewport(Vec2(0, 0), Vec2(100, 100));
+  Camera2d camera;
+  camera.position = viewport.center();
+  camera.size = viewport.size();
+
+  for (auto _ : bench) {
+    for (std::size_t i = 0; i < lines; i++) {
+      shader.queue_text(
+          Vec2(0, i % 100),
+          0,
+          Vec2::ones(),
+          paragraph,
+          Font::DejaVuSans,
+          16,
+          colors[i % 3]);
+    }
+    shader.draw(viewport, camera);
+    shader.clear();
+  }
+
+  const auto& stats = shader.stats();
+  bench.counters["draw_calls"] =
+      benchmark::Counter(stats.draw_calls, benchmark::Counter::kAvgIterations);
+  bench.counters["bytes_per_glyph"] =
+      stats.instances > 0 ? double(stats.bytes_uploaded) / stats.instances : 0;
+  bench.SetItemsProcessed(stats.instances);
+}
+BENCHMARK(BM_Text2dShaderDraw)->Arg(10)->Arg(100);
@@ -4,6 +4,8 @@
 int main() {
   dgui::Gui gui;
   gui.open();
+  // Only redraw when something changes
+  gui.idle_mode(true);
 
   while (gui.poll()) {
     gui.group();
@@ -0,0 +1,65 @@
+#include <datagui/gui.hpp>
+#include <iostream>
+
+// Runs a fixed number of frames offscreen with scripted input, then prints
+// the frame timings. Works without a display, eg: on a build agent.
+
+int main() {
+  dgui::Gui gui;
+  gui.open("headless", 900, 600, dgui::WindowMode::Headless);
+  auto& window = gui.window();
+
+  const std::size_t frame_count = 600;
+  std::size_t frame = 0;
+  int clicks = 0;
+
+  while (gui.poll()) {
+    gui.group();
+    DGUI_SCOPE(gui);
+
+    gui.text_box("Frame " + std::to_string(frame));
+    if (gui.button("Click Me")) {
+      clicks++;
+    }
+    for (std::size_t i = 0; i < 20; i++) {
+      std::ignore = gui.text_input("Item " + std::to_string(i));
+    }
+
+    // Sweep the mouse across the window, clicking the button periodically
+    float t = float(frame % 100) / 100;
+    window.inject_mouse_pos(dgui::Vec2(t * 900, t * 600));
+    if (frame % 50 == 0) {
+      window.inject_mouse_pos(dgui::Vec2(40, 40));
+      window.inject_mouse_button(
+          dgui::MouseButton::Left,
+          dgui::MouseAction::Press);
+      window.inject_mouse_button(
+          dgui::MouseButton::Left,
+          dgui::MouseAction::Release);
+    }
+
+    frame++;
+    if (frame == frame_count) {
+      window.request_close();
+    }
+  }
+
+  const char* names[] =
+      {"build", "layout", "render", "flush", "events", "swap"};
+  const auto& stats = gui.frame_stats();
+  std::cout << "Frames: " << stats.frame_count() << ", clicks: " << clicks
+            << std::endl;
+  for (std::size_t i = 0; i < dgui::FramePhaseCount; i++) {
+    auto timing = stats.timing(dgui::FramePhase(i));
+    std::cout << names[i] << ": mean " << timing.mean * 1e3 << " ms, p99 "
+              << timing.p99 * 1e3 << " ms" << std::endl;
+  }
+  const auto& counters = stats.counters();
+  std::cout << "Last frame: " << counters.arena_allocations
+            << " arena allocations, " << counters.arena_heap_allocations
+            << " from the heap" << std::endl;
+  std::cout << "Last frame: " << counters.text_cache_hits
+            << " text cache hits, " << counters.text_cache_misses
+            << " misses" << std::endl;
+  return 0;
+}
@@ -0,0 +1,63 @@
+#include <datagui/gui.hpp>
+#include <string>
+#include <vector>
+
+// A large settings panel, where each section is only rebuilt when its values
+// change or one of its elements receives input
+
+struct Section {
+  std::string name;
+  bool enabled = true;
+  float gain = 1;
+  int mode = 0;
+};
+
+int main() {
+  std::vector<Section> sections(500);
+  for (std::size_t i = 0; i < sections.size(); i++) {
+    sections[i].name = "Section " + std::to_string(i);
+  }
+  const std::vector<std::string> modes = {"Off", "Low", "High"};
+
+  dgui::Gui gui;
+  gui.open();
+
+  while (gui.poll()) {
+    gui.group();
+    DGUI_SCOPE(gui);
+
+    auto build = gui.frame_stats().timing(dgui::FramePhase::Build);
+    auto layout = gui.frame_stats().timing(dgui::FramePhase::Layout);
+    gui.text_box(
+        "Build: " + std::to_string(build.mean * 1e3) +
+        " ms, layout: " + std::to_string(layout.mean * 1e3) + " ms");
+
+    for (auto& section : sections) {
+      gui.key(section.name);
+      if (!gui.memo(
+              section.name,
+              section.enabled,
+              section.gain,
+              section.mode)) {
+        continue;
+      }
+      DGUI_SCOPE(gui);
+
+      gui.args().border();
+      gui.group();
+      {
+        DGUI_SCOPE(gui);
+        gui.text_box(section.name);
+        gui.args().horizontal();
+        gui.group();
+        {
+          DGUI_SCOPE(gui);
+          gui.checkbox_v(section.enabled);
+          gui.slider_v(section.gain, 0.f, 10.f);
+          gui.select_v(section.mode, modes);
+        }
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,78 @@
+#include <cmath>
+#include <datagui/gui.hpp>
+#include <iostream>
+
+// Usage:
+// - replay record <path>: Records input until the window is closed
+// - replay replay <path>: Replays the input headless, as fast as possible
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    std::cerr << "Usage: " << argv[0] << " record|replay <path>" << std::endl;
+    return 1;
+  }
+  std::string mode = argv[1];
+  std::string path = argv[2];
+  if (mode != "record" && mode != "replay") {
+    std::cerr << "Invalid mode " << mode << std::endl;
+    return 1;
+  }
+
+  dgui::Gui gui;
+  if (mode == "record") {
+    gui.open("replay", 900, 600);
+    gui.start_recording();
+  } else {
+    // Must match the recorded window size for positions to line up
+    gui.open("replay", 900, 600, dgui::WindowMode::Headless);
+    dgui::InputRecording recording;
+    recording.load(path);
+    gui.start_replay(std::move(recording));
+  }
+
+  std::string name;
+  float value = 0.5;
+  bool checked = false;
+
+  while (gui.poll()) {
+    gui.vsplit(0.5);
+    DGUI_SCOPE(gui);
+
+    gui.group();
+    {
+      DGUI_SCOPE(gui);
+      gui.text_input_v(name);
+      gui.slider_v(value, 0.f, 1.f);
+      gui.checkbox_v(checked);
+      for (std::size_t i = 0; i < 10; i++) {
+        std::ignore = gui.text_input("Item " + std::to_string(i));
+      }
+    }
+
+    auto& plotter = gui.plotter(400, 400);
+    {
+      DGUI_SCOPE(gui);
+      std::vector<float> x, y;
+      for (std::size_t i = 0; i <= 200; i++) {
+        x.push_back(-10 + float(i) / 10);
+        y.push_back(value * std::sin(x.back()));
+      }
+      plotter.plot(x, y);
+    }
+  }
+
+  if (mode == "record") {
+    gui.stop_recording().save(path);
+  } else {
+    // Printed state should match the end of the recording
+    std::cout << "name: " << name << ", value: " << value
+              << ", checked: " << checked << std::endl;
+    const auto& stats = gui.frame_stats();
+    auto layout = stats.timing(dgui::FramePhase::Layout);
+    auto events = stats.timing(dgui::FramePhase::Events);
+    std::cout << "Frames: " << stats.frame_count() << ", layout mean "
+              << layout.mean * 1e3 << " ms, events mean " << events.mean * 1e3
+              << " ms" << std::endl;
+  }
+  return 0;
+}
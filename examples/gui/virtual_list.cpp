@@ -0,0 +1,32 @@
+#include <datagui/gui.hpp>
+#include <string>
+#include <vector>
+
+// Only the rows in view are created, so the cost of each frame doesn't
+// depend on the number of rows
+
+int main() {
+  std::vector<bool> selected(100000, false);
+
+  dgui::Gui gui;
+  gui.open();
+
+  while (gui.poll()) {
+    gui.group();
+    DGUI_SCOPE(gui);
+
+    auto layout = gui.frame_stats().timing(dgui::FramePhase::Layout);
+    gui.text_box(
+        std::to_string(selected.size()) + " rows, layout " +
+        std::to_string(layout.mean * 1e3) + " ms");
+
+    gui.virtual_list(selected.size(), 30, [&](std::size_t i) {
+      bool value = selected[i];
+      if (gui.checkbox_v(value)) {
+        selected[i] = value;
+      }
+      gui.text_box("Row " + std::to_string(i));
+    });
+  }
+  return 0;
+}
@@ -29,6 +29,7 @@ private:
   std::shared_ptr<Data> data;
 
   friend class ImageShader;
+  friend class GuiBatcher;
 };
 
 } // namespace dgui
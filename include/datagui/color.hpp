@@ -57,6 +57,10 @@ public:
   Color multiply(float factor) const;
 };
 
+inline bool operator==(const Color& lhs, const Color& rhs) {
+  return lhs.r == rhs.r && lhs.g == rhs.g && lhs.b == rhs.b && lhs.a == rhs.a;
+}
+
 } // namespace dgui
 
 namespace dpack {
@@ -19,9 +19,14 @@ class Args {
       return &value;
     }
 
-    void consume(T& output) {
-      output = value;
+    // Returns true if the output changed
+    bool consume(T& output) {
+      bool changed = !(output == value);
+      if (changed) {
+        output = value;
+      }
       value = default_value;
+      return changed;
     }
 
   private:
@@ -148,6 +153,13 @@ public:
     return *this;
   }
 
+  // Groups only: render the contents to a texture, which is drawn instead
+  // until anything in the group changes
+  Args& cached() {
+    *cached_ = true;
+    return *this;
+  }
+
   // Other
 
   Args& slider_length(float length) {
@@ -179,6 +191,7 @@ public:
   }
 
 private:
+  // Marks the element dirty if any of its args changed
   void apply(ElementPtr element);
 
   Arg<int> num_cells_ = 1;
@@ -194,6 +207,7 @@ private:
 
   Arg<bool> always_ = false;
   Arg<bool> retain_ = false;
+  Arg<bool> cached_ = false;
 
   ArgOpt<float> slider_length_;
   Arg<bool> split_fixed_ = false;
@@ -19,6 +19,7 @@ enum class Type {
   ColorPicker,
   Dropdown,
   Group,
+  Memo,
   Popup,
   Select,
   Slider,
@@ -27,8 +28,9 @@ enum class Type {
   TextBox,
   TextInput,
   ViewportPtr,
+  VirtualList,
 };
-static constexpr std::size_t TypeCount = 14;
+static constexpr std::size_t TypeCount = 16;
 
 struct Button {
   // Definition
@@ -111,6 +113,7 @@ struct Group {
   Length height = LengthWrap();
   std::optional<Color> bg_color;
   bool border = false;
+  bool cached = false;
 
   // Dependent
   Box2 content_box;
@@ -119,6 +122,18 @@ struct Group {
   LayoutState layout_state;
 };
 
+struct Memo {
+  // Definition
+  std::size_t deps_hash = 0;
+  Layout layout;
+
+  // State
+  // Set when an element inside receives input, so the contents are rebuilt
+  // on the next frame even if the dependencies haven't changed
+  bool dirty = false;
+  LayoutState layout_state;
+};
+
 struct Popup {
   // Definition
   std::string title;
@@ -192,9 +207,13 @@ struct Split {
 struct Tabs {
   // Definition
   std::vector<std::string> labels;
+  // Labels from the previous frame, to check for changes
+  std::vector<std::string> prev_labels;
 
   // Dependent
   float header_height;
+  // Relative to the element position, so they stay valid if only the
+  // position changes
   std::vector<Box2> label_boxes;
 
   // State
@@ -229,4 +248,23 @@ struct ViewportPtr {
   std::unique_ptr<Viewport> viewport;
 };
 
+struct VirtualList {
+  // Definition
+  std::size_t count = 0;
+  float row_height = 0;
+
+  // Args
+  Length width = LengthDynamic();
+  Length height = LengthDynamic();
+
+  // Dependent
+  Box2 content_box;
+
+  // State
+  // Row of the first child, the children being consecutive rows
+  std::size_t first_row = 0;
+  // Only the scroll position and overrun are used
+  LayoutState layout_state;
+};
+
 } // namespace dgui
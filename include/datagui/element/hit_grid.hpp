@@ -0,0 +1,77 @@
+#pragma once
+
+#include "datagui/element/tree.hpp"
+#include "datagui/geometry/box.hpp"
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace dgui {
+
+// Uniform grid over the window, listing the elements which can be under each
+// cell, so the element under a point is found without walking the tree.
+// Built from the laid out tree, so must be rebuilt once any element box or
+// the tree itself changes.
+class HitGrid {
+public:
+  HitGrid(float cell_size = 64) : cell_size(cell_size) {}
+
+  void build(ElementPtr root, const Box2& bounds);
+  void invalidate() {
+    valid_ = false;
+  }
+  bool valid() const {
+    return valid_;
+  }
+
+  // The deepest element in the subtree of root containing the position,
+  // taking the first child containing it at each level, as when walking the
+  // tree. Hidden elements are skipped, and floating elements are also hit
+  // within their float box.
+  // Returns nullopt if the position is outside the bounds, in which case the
+  // tree must be walked instead.
+  std::optional<ElementPtr> find(ElementPtr root, const Vec2& position)
+      const;
+
+  // Number of elements indexed by the last build
+  std::size_t size() const {
+    return entries.size();
+  }
+
+private:
+  struct Entry {
+    ElementPtr element;
+    // Entry of the parent, or -1 if it can't be hit, so the element can only
+    // be found from itself, if floating
+    int parent;
+    // One past the last entry in the subtree, which are stored in pre-order
+    int end;
+    Box2 box;
+    bool has_box;
+    Box2 float_box;
+    bool has_float_box;
+
+    bool contains(const Vec2& position) const {
+      return (has_box && box.contains(position)) ||
+             (has_float_box && float_box.contains(position));
+    }
+  };
+
+  std::size_t cell_index(const Vec2& position) const;
+
+  float cell_size;
+  Box2 bounds;
+  std::size_t cells_x = 0;
+  std::size_t cells_y = 0;
+  bool valid_ = false;
+
+  std::vector<Entry> entries;
+  // Entries overlapping each cell, in pre-order, with cell i in
+  // [cell_begin[i], cell_begin[i + 1])
+  std::vector<std::size_t> cell_begin;
+  std::vector<int> cell_entries;
+  std::unordered_map<ElementPtr, int, ElementPtr::HashFunc>
+      floating_entries;
+};
+
+} // namespace dgui
@@ -1,51 +1,102 @@
 #pragma once
 
-#include <algorithm>
+#include "datagui/element/vector_map.hpp"
+#include <atomic>
+#include <cstdint>
+#include <iterator>
 #include <stdexcept>
-#include <vector>
+#include <unordered_map>
+#include <utility>
 
 namespace dgui {
 
+// Ordered list of unique keys, for keying the elements of a list which can
+// be inserted into and removed from at any position.
+// Stored as a treap ordered by position, so insert(), remove(), operator[]
+// and index() are O(log n). Keys are unique across all lists and are never
+// zero, since a zero key means no key.
 class KeyList {
+  struct Node {
+    std::size_t key;
+    std::uint32_t priority;
+    int parent = -1;
+    int left = -1;
+    int right = -1;
+    std::size_t size = 1;
+    Node(std::size_t key, std::uint32_t priority) :
+        key(key), priority(priority) {}
+  };
+
 public:
   std::size_t append() {
-    std::size_t key = next_key++;
-    keys.push_back(key);
-    return key;
+    return insert(size());
   }
+  std::size_t insert(std::size_t pos);
+  void remove(std::size_t key);
 
-  std::size_t insert(std::size_t pos) {
-    std::size_t key = next_key++;
-    keys.insert(keys.begin() + pos, key);
-    return key;
+  std::size_t operator[](std::size_t i) const;
+  // Position of a key in the list
+  std::size_t index(std::size_t key) const;
+  bool contains(std::size_t key) const {
+    return nodes_by_key.contains(key);
   }
 
-  void remove(std::size_t key) {
-    auto iter = std::find(keys.begin(), keys.end(), key);
-    if (iter == keys.end()) {
-      throw std::runtime_error("Key doesn't exist, cannot remove");
-    }
-    keys.erase(iter);
+  std::size_t size() const {
+    return root == -1 ? 0 : nodes[root].size;
   }
 
-  std::size_t operator[](std::size_t i) const {
-    return keys[i];
-  }
+  class ConstIterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::size_t*;
+    using reference = std::size_t;
 
-  std::size_t size() const {
-    return keys.size();
-  }
+    std::size_t operator*() const {
+      return list->nodes[node].key;
+    }
+    ConstIterator& operator++();
+    ConstIterator operator++(int) {
+      ConstIterator temp = (*this);
+      ++(*this);
+      return temp;
+    }
+    friend bool operator==(
+        const ConstIterator& lhs,
+        const ConstIterator& rhs) {
+      return lhs.node == rhs.node;
+    }
 
-  std::vector<std::size_t>::const_iterator begin() const {
-    return keys.begin();
-  }
-  std::vector<std::size_t>::const_iterator end() const {
-    return keys.end();
+  private:
+    ConstIterator(const KeyList* list, int node) : list(list), node(node) {}
+    const KeyList* list;
+    int node;
+    friend class KeyList;
+  };
+
+  ConstIterator begin() const;
+  ConstIterator end() const {
+    return ConstIterator(this, -1);
   }
 
 private:
-  std::vector<std::size_t> keys;
-  static std::size_t next_key;
+  std::size_t subtree_size(int node) const {
+    return node == -1 ? 0 : nodes[node].size;
+  }
+  // Recalculate the size of a node and set the parent of its children
+  void update(int node);
+  int merge(int lhs, int rhs);
+  // Split into the first count nodes and the rest
+  std::pair<int, int> split(int node, std::size_t count);
+  std::uint32_t next_priority();
+
+  VectorMap<Node> nodes;
+  int root = -1;
+  std::unordered_map<std::size_t, int> nodes_by_key;
+  std::uint32_t random_state = 0x9e3779b9;
+
+  static std::atomic_size_t next_key;
 };
 
 } // namespace dgui
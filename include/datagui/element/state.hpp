@@ -5,6 +5,8 @@
 
 namespace dgui {
 
+// Fields read while traversing the tree for layout and rendering, stored
+// alongside the element links
 struct State {
   // Layout input
   // Define for self set_independent_state(...)
@@ -17,7 +19,6 @@ struct State {
   bool floating = false;
   // If true, then the element has no effect on it's parent layout
   bool float_only = false;
-  FloatingType floating_type = FloatingTypeRelative(Vec2(), Vec2());
 
   // Used when the element is inserted into a layout
   bool force_hidden = false;
@@ -25,8 +26,7 @@ struct State {
   // Layout output
   // Define in set_dependent_state(...)
 
-  // Set on parent
-  Box2 child_mask;
+  bool hidden = false;
 
   Vec2 position;
   Vec2 size;
@@ -34,17 +34,56 @@ struct State {
     return Box2(position, position + size);
   }
 
-  bool hidden = false;
+  // Incremental layout
+
+  // The element or a descendant has changed since set_input_state(...)
+  // was last called. Set with ElementPtr::set_dirty().
+  bool dirty = true;
+  // set_input_state(...) was called this frame, so the element must be
+  // laid out again
+  bool input_changed = false;
+  // The element or a descendant is floating, so the subtree must be
+  // visited even if its layout is unchanged
+  bool contains_floating = false;
+};
 
-  // Other state
+// Fields only used by some elements or during event handling, stored
+// separately so they don't take up space in the traversed data
+struct ColdState {
+  // Layout input, if floating
+  FloatingType floating_type = FloatingTypeRelative(Vec2(), Vec2());
+
+  // Layout output
+  // Set on parent
+  Box2 child_mask;
 
   Box2 float_box;
   int float_priority = 0;
 
+  // Incremental layout
+  // Box from the last set_dependent_state(...), only read by the top-down
+  // pass for elements it doesn't prune
+  Vec2 laid_out_position;
+  Vec2 laid_out_size;
+
   // Event handling
   bool in_focus_tree = false;
   bool focused = false;
   bool hovered = false;
+
+  // Retained rendering
+  // Set when what the element draws may have changed, so it must be
+  // rendered again rather than replaying the commands it last recorded
+  bool render_dirty = true;
+  // Set with render_dirty on the element and its ancestors, for cached
+  // groups, which clear it over their subtree when rendered
+  bool subtree_render_dirty = true;
+  // Commands recorded by the GuiRenderer on a frame, and the mask they were
+  // recorded with
+  std::size_t render_frame = 0;
+  std::size_t render_begin = 0;
+  std::size_t render_end = 0;
+  Box2 render_mask;
 };
 
 } // namespace dgui
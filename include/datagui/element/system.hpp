@@ -14,21 +14,35 @@ public:
 
   virtual void render(ConstElementPtr element, GuiRenderer& renderer) = 0;
 
-  // Return true/false depending on if the event is handled
-  virtual void mouse_event(ElementPtr element, const MouseEvent& event) {}
+  // Mouse, key, text and focus events return true if they changed the
+  // element, so that it is laid out and rendered again
+  virtual bool mouse_event(ElementPtr element, const MouseEvent& event) {
+    return false;
+  }
   virtual void mouse_hover(ElementPtr element, const Vec2& mouse_pos) {}
+  // Return true/false depending on if the event is handled
   virtual bool scroll_event(ElementPtr element, const ScrollEvent& event) {
     return false;
   }
-  virtual void key_event(ElementPtr element, const KeyEvent& event) {}
-  virtual void text_event(ElementPtr element, const TextEvent& event) {}
+  virtual bool key_event(ElementPtr element, const KeyEvent& event) {
+    return false;
+  }
+  virtual bool text_event(ElementPtr element, const TextEvent& event) {
+    return false;
+  }
 
   // Node is focused via tab instead of clicking on it
-  virtual void focus_enter(ElementPtr element) {}
+  virtual bool focus_enter(ElementPtr element) {
+    return false;
+  }
   // Node is unfocused via tab, escape or clicking on another node
   // success = should the changes be retained?
-  virtual void focus_leave(ElementPtr element, bool success) {}
-  virtual void focus_tree_leave(ElementPtr element) {}
+  virtual bool focus_leave(ElementPtr element, bool success) {
+    return false;
+  }
+  virtual bool focus_tree_leave(ElementPtr element) {
+    return false;
+  }
 };
 
 } // namespace dgui
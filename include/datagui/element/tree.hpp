@@ -6,6 +6,8 @@
 #include "datagui/element/vector_map.hpp"
 #include <assert.h>
 #include <stdexcept>
+#include <unordered_map>
+#include <vector>
 
 namespace dgui {
 
@@ -18,19 +20,21 @@ class Tree {
   // ===========================================================
   // ElementNode
 
+  // Holds the links and the state read when traversing the tree. The rest
+  // of the element state is in cold_states, at the same index.
   struct ElementNode {
-    std::size_t id;
-
     int parent = -1;
     int prev = -1;
     int next = -1;
     int first_child = -1;
     int last_child = -1;
-    int first_variable = -1;
 
-    State state;
     Type type;
+    State state;
+
+    int first_variable = -1;
     std::size_t type_index;
+    std::size_t id;
   };
 
   // ===========================================================
@@ -59,14 +63,14 @@ public:
     using data_ref_t = std::conditional_t<IsConst, const T&, T&>;
 
   public:
+    // The value is heap allocated, so the pointer from construction is
+    // still valid
     std::conditional_t<IsConst, const T&, T&> operator*() const {
-      assert(tree && variable != -1);
-      auto data_ptr = tree->variables[variable].data.template cast<T>();
+      assert(tree && variable != -1 && data_ptr);
       return *data_ptr;
     }
     std::conditional_t<IsConst, const T*, T*> operator->() const {
-      assert(tree && variable != -1);
-      auto data_ptr = tree->variables[variable].data.template cast<T>();
+      assert(tree && variable != -1 && data_ptr);
       return data_ptr;
     }
 
@@ -120,7 +124,7 @@ public:
       return VarPtr_(tree, element, tree->variables[variable].next);
     }
     operator bool() const {
-      return variable != -1;
+      return variable != -1 && tree->variables.contains(variable, generation);
     }
     bool valid() const {
       return tree;
@@ -130,6 +134,7 @@ public:
     Var_<T, Const> create(const T& value) {
       assert(tree && variable == -1);
       variable = tree->create_variable(element);
+      generation = tree->variables.generation(variable);
       tree->variables[variable].data = UniqueAny::Make<T>(value);
       return Var_<T, Const>(tree, variable);
     }
@@ -140,15 +145,20 @@ public:
       return Var_<T, Const>(tree, variable);
     }
 
-    VarPtr_() : tree(nullptr), element(-1), variable(-1) {}
+    VarPtr_() : tree(nullptr), element(-1), variable(-1), generation(0) {}
 
   private:
     VarPtr_(tree_ptr_t tree, int element, int variable) :
-        tree(tree), element(element), variable(variable) {}
+        tree(tree),
+        element(element),
+        variable(variable),
+        generation(
+            variable == -1 ? 0 : tree->variables.generation(variable)) {}
 
     tree_ptr_t tree;
     int element;
     int variable;
+    std::uint32_t generation;
 
     template <bool Const_>
     friend class ElementPtr_;
@@ -171,8 +181,8 @@ public:
   public:
     struct FloatCompare {
       bool operator()(const ElementPtr_& lhs, const ElementPtr_& rhs) const {
-        return std::tie(lhs.state().float_priority, lhs.index) <
-               std::tie(rhs.state().float_priority, rhs.index);
+        return std::tie(lhs.cold_state().float_priority, lhs.index) <
+               std::tie(rhs.cold_state().float_priority, rhs.index);
       }
     };
     friend struct FloatCompare;
@@ -205,6 +215,7 @@ public:
     PROPS_METHOD(ColorPicker, color_picker)
     PROPS_METHOD(Dropdown, dropdown)
     PROPS_METHOD(Group, group)
+    PROPS_METHOD(Memo, memo)
     PROPS_METHOD(Popup, popup)
     PROPS_METHOD(Select, select)
     PROPS_METHOD(Slider, slider)
@@ -213,6 +224,7 @@ public:
     PROPS_METHOD(TextBox, text_box)
     PROPS_METHOD(TextInput, text_input)
     PROPS_METHOD(ViewportPtr, viewport)
+    PROPS_METHOD(VirtualList, virtual_list)
 
 #undef PROPS_METHOD
 
@@ -268,20 +280,46 @@ public:
       assert(tree && index != -1);
       return tree->elements[index].state;
     }
+    std::conditional_t<IsConst, const ColdState&, ColdState&>
+    cold_state() const {
+      assert(tree && index != -1);
+      assert(tree->elements.contains(index));
+      return tree->cold_states[index];
+    }
+
+    // Mark the element and its ancestors to be laid out again, after
+    // changing anything read by set_input_state(...)
+    void set_dirty() const {
+      assert(tree && index != -1);
+      tree->set_dirty(index);
+    }
+    // Mark the element to be rendered again, after changing anything read
+    // by render(...) only
+    void set_render_dirty() const {
+      assert(tree && index != -1);
+      tree->set_render_dirty(index);
+    }
 
+    // False if the element has been removed, even if its slot is reused
     operator bool() const {
-      return tree && index != -1 && tree->elements.contains(index);
+      return tree && index != -1 &&
+             tree->elements.contains(index, generation);
     }
 
+    // Create an element at the current position, before the current
+    // element if there is one
     void create(Type type, std::size_t id = 0) {
       assert(tree);
       if (parent_ == -1) {
+        assert(index == -1);
         index = tree->create_element(parent_, -1, id, type);
       } else {
         assert(tree->elements.contains(parent_));
-        int prev = tree->elements[parent_].last_child;
+        int prev = index == -1 ? tree->elements[parent_].last_child
+                               : tree->elements[index].prev;
         index = tree->create_element(parent_, prev, id, type);
       }
+      generation = tree->elements.generation(index);
     }
     void reset(Type type, std::size_t id = 0) const {
       assert(tree && index != -1);
@@ -294,8 +332,31 @@ public:
       return ElementPtr_(tree, parent_, next);
     }
 
+    // Returns true if the element was created
+    // A non-zero id is a key, which must be unique among siblings. If the
+    // current element doesn't match, a sibling with the key is moved here,
+    // keeping its state, children and variables, otherwise a new element is
+    // inserted. Elements left in between are matched by later calls or
+    // erased by expect_end().
+    // Elements without a key are matched in order, erasing any that don't
+    // match.
     bool expect(Type type, std::size_t id = 0) {
       assert(tree);
+      bool keyed = id != 0 && parent_ != -1;
+      if (keyed && (index == -1 || id != tree->elements[index].id)) {
+        int found = tree->find_keyed(parent_, id);
+        if (found == -1) {
+          create(type, id);
+          return true;
+        }
+        tree->move_element(found, index);
+        index = found;
+        generation = tree->elements.generation(index);
+        if (type != tree->elements[index].type) {
+          throw ElementError("Incorrect type");
+        }
+        return false;
+      }
       while (index != -1 && id != tree->elements[index].id) {
         (*this) = erase();
       }
@@ -316,7 +377,7 @@ public:
     }
 
     friend bool operator==(const ElementPtr_& lhs, const ElementPtr_& rhs) {
-      return lhs.index == rhs.index;
+      return lhs.index == rhs.index && lhs.generation == rhs.generation;
     }
 
     std::size_t id() const {
@@ -340,24 +401,34 @@ public:
         bool OtherConst,
         typename = std::enable_if_t<IsConst || !OtherConst>>
     ElementPtr_(const ElementPtr_<OtherConst>& other) :
-        tree(other.tree), parent_(other.parent_), index(other.index) {}
+        tree(other.tree),
+        parent_(other.parent_),
+        index(other.index),
+        generation(other.generation) {}
 
     template <
         bool OtherConst,
         typename = std::enable_if_t<IsConst || !OtherConst>>
     ElementPtr_(ElementPtr_<OtherConst>&& other) :
-        tree(other.tree), parent_(other.parent_), index(other.index) {}
+        tree(other.tree),
+        parent_(other.parent_),
+        index(other.index),
+        generation(other.generation) {}
 
-    ElementPtr_() : tree(nullptr), parent_(-1), index(-1) {}
+    ElementPtr_() : tree(nullptr), parent_(-1), index(-1), generation(0) {}
 
   private:
     using tree_ptr_t = std::conditional_t<IsConst, const Tree*, Tree*>;
     ElementPtr_(tree_ptr_t tree, int parent, int index) :
-        tree(tree), parent_(parent), index(index) {}
+        tree(tree),
+        parent_(parent),
+        index(index),
+        generation(index == -1 ? 0 : tree->elements.generation(index)) {}
 
     tree_ptr_t tree;
     int parent_;
     int index;
+    std::uint32_t generation;
 
     friend class Tree;
 
@@ -381,22 +452,43 @@ public:
     return VarPtr(this, -1, external_var_);
   }
 
-  bool has_removed(const ConstElementPtr& ptr) {
-    for (auto index : removed_elements) {
-      if (index == ptr.index) {
-        return true;
-      }
-    }
-    return false;
+  // Compact the element, variable and props stores which have at least
+  // min_slots slots, of which less than min_occupancy are in use. Returns
+  // true if elements were moved, after which handles held from before must
+  // be updated with remap().
+  bool compact(float min_occupancy = 0.5, std::size_t min_slots = 64);
+  // Update a handle after compact(), or invalidate it if its element had
+  // already been removed
+  void remap(ElementPtr& element);
+
+  // True if elements have been created, removed or marked dirty since
+  // clear_modified(), so the tree needs laying out and drawing again
+  bool modified() const {
+    return modified_;
   }
-  void clear_removed() {
-    removed_elements.clear();
+  void clear_modified() {
+    modified_ = false;
   }
 
 private:
   int create_element(int parent, int prev, std::size_t id, Type type);
   void reset_element(int element, std::size_t id, Type type);
   void remove_element(int element, bool children_only = false);
+  // Relink an element before next within its parent, or last if next is -1
+  void move_element(int element, int next);
+
+  void set_dirty(int element);
+  void set_render_dirty(int element);
+
+  void insert_key(int element);
+  void erase_key(int element);
+  int find_keyed(int parent, std::size_t id) const {
+    auto iter = keyed_elements.find(ElementKey{parent, id});
+    if (iter == keyed_elements.end()) {
+      return -1;
+    }
+    return iter->second;
+  }
 
   int emplace_type(Type type);
   void pop_type(Type type, std::size_t index);
@@ -406,9 +498,29 @@ private:
 
   int root_ = -1;
   VectorMap<ElementNode> elements;
+  // Indexed by element, only valid for elements that are in use
+  std::vector<ColdState> cold_states;
   VectorMap<VarNode> variables;
   int external_var_ = -1;
-  std::vector<int> removed_elements;
+
+  // Elements with a non-zero id, by parent and id
+  struct ElementKey {
+    int parent;
+    std::size_t id;
+    bool operator==(const ElementKey& other) const {
+      return parent == other.parent && id == other.id;
+    }
+  };
+  struct ElementKeyHash {
+    std::size_t operator()(const ElementKey& key) const {
+      return key.id ^ (std::hash<int>{}(key.parent) << 1);
+    }
+  };
+  std::unordered_map<ElementKey, int, ElementKeyHash> keyed_elements;
+
+  // Old to new element indices from the last compact()
+  std::vector<int> element_remap;
+  bool modified_ = false;
 
   VectorMap<Button> button;
   VectorMap<Checkbox> checkbox;
@@ -416,6 +528,7 @@ private:
   VectorMap<ColorPicker> color_picker;
   VectorMap<Dropdown> dropdown;
   VectorMap<Group> group;
+  VectorMap<Memo> memo;
   VectorMap<Popup> popup;
   VectorMap<Select> select;
   VectorMap<Slider> slider;
@@ -424,6 +537,7 @@ private:
   VectorMap<TextBox> text_box;
   VectorMap<TextInput> text_input;
   VectorMap<ViewportPtr> viewport;
+  VectorMap<VirtualList> virtual_list;
 };
 
 using ElementPtr = Tree::ElementPtr;
@@ -437,4 +551,15 @@ using Var = Tree::Var<T>;
 template <typename T>
 using ConstVar = Tree::ConstVar<T>;
 
+// Assign a value of an element, marking the element dirty if it has
+// changed, which requests a redraw
+template <typename T>
+void update(ElementPtr element, T& dest, const T& value) {
+  if (dest == value) {
+    return;
+  }
+  dest = value;
+  element.set_dirty();
+}
+
 } // namespace dgui
@@ -1,59 +1,93 @@
 #pragma once
 
-#include <memory>
+#include <utility>
 
 namespace dgui {
 
+// Owns a value of any type, checked on access by comparing a per-type id
+// instead of using RTTI.
+// Values are always heap allocated, since the gui hands out references to
+// variables which must stay valid when Tree::variables reallocates.
 class UniqueAny {
-  class ValueBase {
-  public:
-    virtual ~ValueBase() {}
-  };
-
   template <typename T>
-  class Value : public ValueBase {
-  public:
-    Value(T&& value) : value(std::move(value)) {}
-    T value;
+  struct TypeTag {
+    static constexpr char id = 0;
   };
-
-  class ValueNull : public ValueBase {};
+  using type_id_t = const void*;
+  template <typename T>
+  static type_id_t type_id() {
+    return &TypeTag<T>::id;
+  }
 
 public:
-  UniqueAny() : value(std::make_unique<ValueNull>()) {}
-  UniqueAny(UniqueAny&& other) = default;
-  UniqueAny& operator=(UniqueAny&& other) = default;
+  UniqueAny() : type(nullptr), value(nullptr), destroy(nullptr) {}
+  ~UniqueAny() {
+    reset();
+  }
+
+  UniqueAny(UniqueAny&& other) :
+      type(other.type), value(other.value), destroy(other.destroy) {
+    other.release();
+  }
+  UniqueAny& operator=(UniqueAny&& other) {
+    if (this != &other) {
+      reset();
+      type = other.type;
+      value = other.value;
+      destroy = other.destroy;
+      other.release();
+    }
+    return *this;
+  }
+
+  UniqueAny(const UniqueAny&) = delete;
+  UniqueAny& operator=(const UniqueAny&) = delete;
 
   template <typename T, typename... Args>
   static UniqueAny Make(Args&&... args) {
-    return UniqueAny(T(std::forward<Args>(args)...));
+    UniqueAny result;
+    result.value = new T(std::forward<Args>(args)...);
+    result.type = type_id<T>();
+    result.destroy = [](void* value) { delete static_cast<T*>(value); };
+    return result;
   }
 
   template <typename T>
   T* cast() {
-    if (auto ptr = dynamic_cast<Value<T>*>(value.get())) {
-      return &ptr->value;
+    if (type != type_id<T>()) {
+      return nullptr;
     }
-    return nullptr;
+    return static_cast<T*>(value);
   }
 
   template <typename T>
   const T* cast() const {
-    if (auto ptr = dynamic_cast<const Value<T>*>(value.get())) {
-      return &ptr->value;
+    if (type != type_id<T>()) {
+      return nullptr;
     }
-    return nullptr;
+    return static_cast<const T*>(value);
   }
 
   operator bool() const {
-    return !dynamic_cast<const ValueNull*>(value.get());
+    return value;
   }
 
 private:
-  template <typename T>
-  UniqueAny(T&& value) : value(std::make_unique<Value<T>>(std::move(value))) {}
+  void reset() {
+    if (value) {
+      destroy(value);
+    }
+    release();
+  }
+  void release() {
+    type = nullptr;
+    value = nullptr;
+    destroy = nullptr;
+  }
 
-  std::unique_ptr<ValueBase> value;
+  type_id_t type;
+  void* value;
+  void (*destroy)(void*);
 };
 
 } // namespace dgui
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <assert.h>
+#include <bit>
+#include <cstdint>
 #include <cstring>
 #include <memory>
 #include <vector>
@@ -9,6 +12,9 @@ namespace dgui {
 
 template <typename T>
 class VectorMap {
+  using word_t = std::uint64_t;
+  static constexpr std::size_t word_bits = 64;
+
 public:
   VectorMap() : data(nullptr), data_size(0), data_capacity(0), size_(0) {}
 
@@ -16,11 +22,11 @@ public:
     destruct();
   }
 
-  VectorMap(const VectorMap& other) {
+  VectorMap(const VectorMap& other) : VectorMap() {
     copy_from(other);
   }
 
-  VectorMap(VectorMap&& other) {
+  VectorMap(VectorMap&& other) : VectorMap() {
     move_from(other);
   }
 
@@ -37,16 +43,26 @@ public:
   }
 
   bool contains(int i) const {
-    return i >= 0 && i < valid.size() && valid[i];
+    return i >= 0 && std::size_t(i) < data_size && is_valid(i);
+  }
+
+  // Incremented each time a slot is popped, so a handle storing the
+  // generation can tell if its slot has since been reused
+  std::uint32_t generation(int i) const {
+    assert(i >= 0 && std::size_t(i) < generations.size());
+    return generations[i];
+  }
+  bool contains(int i, std::uint32_t generation) const {
+    return contains(i) && generations[i] == generation;
   }
 
   const T& operator[](int i) const {
-    assert(valid[i]);
+    assert(contains(i));
     return data[i];
   }
 
   T& operator[](int i) {
-    assert(valid[i]);
+    assert(contains(i));
     return data[i];
   }
 
@@ -56,26 +72,28 @@ public:
     if (free.empty()) {
       index = data_size;
       expand_data(data_size + 1);
-      valid.push_back(false);
+      if (generations.size() < data_size) {
+        generations.push_back(0);
+      }
     } else {
       index = free.back();
       free.pop_back();
     }
-    assert(data_size == valid.size());
-    assert(!valid[index]);
+    assert(!is_valid(index));
     assert(index >= 0 && index < data_size);
 
     new (&data[index]) T(std::forward<Args>(args)...);
-    valid[index] = true;
+    set_valid(index, true);
     size_++;
     return index;
   }
 
   void pop(int index) {
-    assert(index < valid.size() && valid[index]);
+    assert(contains(index));
     free.push_back(index);
     data[index].~T();
-    valid[index] = false;
+    set_valid(index, false);
+    generations[index]++;
     assert(size_ > 0);
     size_--;
   }
@@ -83,24 +101,61 @@ public:
   std::size_t size() const {
     return size_;
   }
+  // Number of slots in use or free, the upper bound of indices
+  std::size_t slots() const {
+    return data_size;
+  }
+
+  // Move all values to the start, so that indices are [0, size())
+  // Returns the new index for each old index, or -1 for free slots.
+  // The generation of every slot is incremented, since indices change.
+  std::vector<int> compact() {
+    std::vector<int> remap(data_size, -1);
+    std::size_t to = 0;
+    for_each_valid([&](std::size_t from) {
+      if (from != to) {
+        new (&data[to]) T(std::move(data[from]));
+        data[from].~T();
+      }
+      remap[from] = to;
+      to++;
+    });
+    assert(to == size_);
+
+    std::fill(valid.begin(), valid.end(), 0);
+    for (std::size_t i = 0; i < size_; i++) {
+      set_valid(i, true);
+    }
+    for (std::size_t i = 0; i < data_size; i++) {
+      generations[i]++;
+    }
+    data_size = size_;
+    valid.resize((data_size + word_bits - 1) / word_bits);
+    free.clear();
+    return remap;
+  }
 
   template <bool Const>
   class Iterator_ {
     using parent_t = std::conditional_t<Const, const VectorMap*, VectorMap*>;
+    using value_t = std::conditional_t<Const, const T, T>;
 
   public:
-    T& operator*() const {
-      return (*parent)[static_cast<int>(index)];
+    value_t& operator*() const {
+      return parent->data[index];
     }
-    T* operator->() const {
-      return &(*parent)[static_cast<int>(index)];
+    value_t* operator->() const {
+      return &parent->data[index];
     }
 
     Iterator_& operator++() {
       assert(index < parent->data_size);
-      index++;
-      while (index < parent->data_size && !parent->valid[index]) {
-        index++;
+      if (bits != 0) {
+        index = (index / word_bits) * word_bits + std::countr_zero(bits);
+        bits &= bits - 1;
+      } else {
+        index = parent->next_valid((index / word_bits + 1) * word_bits);
+        load_bits();
       }
       return *this;
     }
@@ -118,17 +173,25 @@ public:
         bool OtherConst,
         typename = std::enable_if_t<Const || !OtherConst>>
     Iterator_(const Iterator_<OtherConst>& other) :
-        parent(other.parent), index(other.index) {}
+        parent(other.parent), index(other.index), bits(other.bits) {}
 
   private:
     Iterator_(parent_t parent, std::size_t index) :
-        parent(parent), index(index) {
-      while (index < parent->data_size && !parent->valid[index]) {
-        index++;
+        parent(parent), index(parent->next_valid(index)) {
+      load_bits();
+    }
+    // Valid slots after index within the same word
+    void load_bits() {
+      if (index >= parent->data_size) {
+        bits = 0;
+        return;
       }
+      bits = parent->valid[index / word_bits] &
+             ((~word_t(0) << (index % word_bits)) << 1);
     }
     parent_t parent;
     std::size_t index;
+    word_t bits;
     friend class VectorMap;
 
     template <bool OtherConst>
@@ -138,17 +201,13 @@ public:
   using Iterator = Iterator_<false>;
 
   Iterator begin() {
-    std::size_t index = 0;
-    while (index < valid.size() && !valid[index]) {
-      index++;
-    }
-    return Iterator(this, index);
+    return Iterator(this, 0);
   }
   Iterator end() {
     return Iterator(this, data_size);
   }
   ConstIterator begin() const {
-    return const_cast<VectorMap<T>*>(this)->begin();
+    return ConstIterator(this, 0);
   }
   ConstIterator end() const {
     return ConstIterator(this, data_size);
@@ -161,8 +220,49 @@ public:
   }
 
 private:
+  bool is_valid(std::size_t i) const {
+    return (valid[i / word_bits] >> (i % word_bits)) & 1;
+  }
+  void set_valid(std::size_t i, bool value) {
+    word_t mask = word_t(1) << (i % word_bits);
+    if (value) {
+      valid[i / word_bits] |= mask;
+    } else {
+      valid[i / word_bits] &= ~mask;
+    }
+  }
+
+  // First valid index at or after i, or data_size if none
+  std::size_t next_valid(std::size_t i) const {
+    if (i >= data_size) {
+      return data_size;
+    }
+    std::size_t word = i / word_bits;
+    word_t bits = valid[word] & (~word_t(0) << (i % word_bits));
+    while (bits == 0) {
+      word++;
+      if (word == valid.size()) {
+        return data_size;
+      }
+      bits = valid[word];
+    }
+    return word * word_bits + std::countr_zero(bits);
+  }
+
+  template <typename Func>
+  void for_each_valid(const Func& func) const {
+    for (std::size_t word = 0; word < valid.size(); word++) {
+      word_t bits = valid[word];
+      while (bits != 0) {
+        func(word * word_bits + std::countr_zero(bits));
+        bits &= bits - 1;
+      }
+    }
+  }
+
   void expand_data(std::size_t required) {
     assert(required >= data_size);
+    valid.resize((required + word_bits - 1) / word_bits, 0);
     if (required <= data_capacity) {
       data_size = required;
       return;
@@ -183,105 +283,103 @@ private:
       new_capacity *= 2;
     }
     T* new_data = (T*)malloc(sizeof(T) * new_capacity);
-    move_data(data, new_data, data_size);
+    move_data(data, new_data);
     ::free(data);
     data = new_data;
     data_size = required;
     data_capacity = new_capacity;
   }
 
-  void copy_data(const T* from, T* to, std::size_t size) {
+  // Only valid slots hold constructed objects, popped slots have already
+  // been destructed
+
+  void copy_data(const VectorMap& other) {
     if constexpr (std::is_trivially_copy_constructible_v<T>) {
-      memcpy(to, from, sizeof(T) * size);
+      memcpy(data, other.data, sizeof(T) * other.data_size);
     }
     if constexpr (!std::is_trivially_copy_constructible_v<T>) {
-      for (std::size_t i = 0; i < size; i++) {
-        new (to + i) T(from[i]);
-      }
+      other.for_each_valid([&](std::size_t i) {
+        new (data + i) T(other.data[i]);
+      });
     }
   }
 
-  void move_data(T* from, T* to, std::size_t size) {
+  // Leaves the objects in from destructed
+  void move_data(T* from, T* to) {
     if constexpr (std::is_trivially_move_constructible_v<T>) {
-      memcpy(to, from, sizeof(T) * size);
+      memcpy(to, from, sizeof(T) * data_size);
     }
     if constexpr (!std::is_trivially_move_constructible_v<T>) {
-      for (std::size_t i = 0; i < size; i++) {
+      for_each_valid([&](std::size_t i) {
         new (to + i) T(std::move(from[i]));
-      }
+        from[i].~T();
+      });
     }
   }
 
   void destruct_data() {
     if constexpr (!std::is_trivially_destructible_v<T>) {
-      for (std::size_t i = 0; i < data_size; i++) {
-        data[i].~T();
-      }
+      for_each_valid([&](std::size_t i) { data[i].~T(); });
     }
   }
 
   void destruct() {
-    assert(data_size == valid.size());
     assert(data || (data_size == 0 && data_capacity == 0));
     if (data) {
       destruct_data();
       ::free(data);
+      data = nullptr;
       data_size = 0;
       data_capacity = 0;
     }
     valid.clear();
+    generations.clear();
     free.clear();
     size_ = 0;
   }
 
   void copy_from(const VectorMap& other) {
-    if (data) {
-      ::free(data);
-      data_size = 0;
-      data_capacity = 0;
-    }
-    if (other.data) {
-      data_size = other.data_size;
-      data_capacity = other.data_capacity;
-      data = (T*)malloc(data_capacity * sizeof(T));
-      copy_data(other.data, data, data_size);
-    }
-
+    assert(!data);
     valid = other.valid;
+    generations = other.generations;
     free = other.free;
     size_ = other.size_;
-  }
 
-  void move_from(VectorMap& other) {
-    if (data) {
-      ::free(data);
-      data_size = 0;
-      data_capacity = 0;
-    }
     if (other.data) {
       data_size = other.data_size;
       data_capacity = other.data_capacity;
-      if constexpr (std::is_trivially_move_constructible_v<T>) {
-        data = other.data;
-        other.data = nullptr;
-      }
-      if constexpr (!std::is_trivially_move_constructible_v<T>) {
-        data = (T*)malloc(sizeof(T) * data_capacity);
-        move_data(other.data, data, data_size);
-        other.data = nullptr;
-      }
+      data = (T*)malloc(data_capacity * sizeof(T));
+      copy_data(other);
     }
+  }
+
+  void move_from(VectorMap& other) {
+    assert(!data);
+    // Take ownership of the buffer, the objects don't need to move
+    data = other.data;
+    data_size = other.data_size;
+    data_capacity = other.data_capacity;
+    other.data = nullptr;
+    other.data_size = 0;
+    other.data_capacity = 0;
 
     valid = std::move(other.valid);
+    generations = std::move(other.generations);
     free = std::move(other.free);
     size_ = other.size_;
+    other.valid.clear();
+    other.generations.clear();
+    other.free.clear();
+    other.size_ = 0;
   }
 
   T* data;
   std::size_t data_size;
   std::size_t data_capacity;
 
-  std::vector<bool> valid;
+  // Bit i of word i / 64 is set if slot i holds a value
+  std::vector<word_t> valid;
+  std::vector<std::uint32_t> generations;
   std::vector<int> free;
   std::size_t size_;
 };
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <stack>
+#include <vector>
+
+namespace dgui {
+
+// Monotonic allocator for data that only lives until the end of a frame.
+// Allocations bump a pointer into a single buffer and deallocation is a
+// no-op, with everything released at once by reset().
+// If the buffer runs out, allocations fall back to the heap and the buffer
+// is grown on the next reset() to fit the whole frame, so frames of a
+// similar size after the first don't touch the heap.
+// Allocation is thread-safe, for use by parallel layout, but reset() isn't.
+class FrameArena : public std::pmr::memory_resource {
+public:
+  FrameArena(std::size_t initial_capacity = 64 * 1024);
+
+  void reset();
+
+  // Since the last reset
+  std::size_t allocations() const {
+    return allocations_;
+  }
+  std::size_t heap_allocations() const {
+    return heap_allocations_;
+  }
+  std::size_t bytes_used() const {
+    return used + overflow_bytes;
+  }
+
+  std::size_t capacity() const {
+    return capacity_;
+  }
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void*, std::size_t, std::size_t) override {}
+  bool do_is_equal(const std::pmr::memory_resource& other)
+      const noexcept override {
+    return this == &other;
+  }
+
+  std::unique_ptr<std::byte[]> buffer;
+  std::size_t capacity_;
+  std::atomic_size_t used = 0;
+
+  std::mutex overflow_mutex;
+  std::vector<std::unique_ptr<std::byte[]>> overflow;
+  std::size_t overflow_bytes = 0;
+
+  std::atomic_size_t allocations_ = 0;
+  std::atomic_size_t heap_allocations_ = 0;
+};
+
+// Containers for use with a FrameArena
+template <typename T>
+using FrameVector = std::pmr::vector<T>;
+template <typename T>
+using FrameStack = std::stack<T, std::pmr::vector<T>>;
+
+} // namespace dgui
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace dgui {
+
+enum class FramePhase {
+  Build, // Caller building the tree, between polls
+  Layout, // Gui::calculate_sizes()
+  Render, // Gui::render(), excluding flushes and the buffer swap
+  Flush, // GuiRenderer::render(), summed over layers
+  Events, // Gui::event_handling(), excluding waiting for events
+  Swap, // Swapping the window buffers
+};
+static constexpr std::size_t FramePhaseCount = 6;
+
+// Timings in seconds, over the frames in the rolling window
+struct PhaseTiming {
+  double min = 0;
+  double mean = 0;
+  double p99 = 0;
+  double last = 0;
+  std::size_t samples = 0;
+};
+
+// Counts for the most recent frame
+struct FrameCounters {
+  // False if the frame was skipped in idle mode
+  bool redrawn = false;
+
+  // Calls to set_input_state(...) and set_dependent_state(...), which
+  // only visit elements that are dirty or whose box changed
+  std::size_t elements_laid_out = 0;
+  std::size_t elements_positioned = 0;
+  std::size_t elements_rendered = 0;
+  // Elements rendered by replaying the commands recorded on the previous
+  // frame, since nothing they draw changed
+  std::size_t elements_reused = 0;
+  // Elements not rendered since their box is outside the mask, not counting
+  // the descendants skipped with them
+  std::size_t elements_culled = 0;
+
+  std::size_t shape_instances = 0;
+  std::size_t text_glyphs = 0;
+  std::size_t image_instances = 0;
+  std::size_t draw_calls = 0;
+  std::size_t bytes_uploaded = 0;
+  // Vertex buffer storage orphaned or grown, see RenderStats
+  std::size_t buffer_allocations = 0;
+  // Layers drawn from the buffers uploaded on the previous frame
+  std::size_t layers_reused = 0;
+  // Fraction of the window area redrawn, where the frame may have changed
+  double damaged_fraction = 0;
+  // Cached groups drawn from their textures, and how many of those were
+  // rendered to them again since something in them changed
+  std::size_t cached_groups = 0;
+  std::size_t cached_groups_rendered = 0;
+  // Texture memory held by cached groups, see Gui::render_cache_limit()
+  std::size_t cache_memory = 0;
+
+  // Lookups of measured text in the FontManager cache
+  std::size_t text_cache_hits = 0;
+  std::size_t text_cache_misses = 0;
+
+  // Allocations from the frame arena, and how many of those didn't fit in
+  // its buffer and went to the heap, which should be zero in steady state.
+  // Heap allocations made outside the arena, eg: by element props, aren't
+  // counted.
+  std::size_t arena_allocations = 0;
+  std::size_t arena_heap_allocations = 0;
+
+  // Time of each GuiRenderer::render() call: the root tree, then each
+  // floating layer in order of priority
+  std::vector<double> layer_times;
+};
+
+class FrameStats {
+  using clock_t = std::chrono::steady_clock;
+
+public:
+  FrameStats(std::size_t window_size = 120);
+
+  PhaseTiming timing(FramePhase phase) const;
+  const FrameCounters& counters() const {
+    return counters_;
+  }
+  std::size_t frame_count() const {
+    return frame_count_;
+  }
+
+  // Timer for a phase, recorded when stopped
+  class Timer {
+  public:
+    double elapsed() const {
+      return std::chrono::duration<double>(clock_t::now() - start_).count();
+    }
+    double stop() {
+      double result = elapsed();
+      stats.record(phase, result);
+      return result;
+    }
+
+  private:
+    Timer(FrameStats& stats, FramePhase phase) :
+        stats(stats), phase(phase), start_(clock_t::now()) {}
+    FrameStats& stats;
+    FramePhase phase;
+    clock_t::time_point start_;
+    friend class FrameStats;
+  };
+  Timer start(FramePhase phase) {
+    return Timer(*this, phase);
+  }
+
+  void frame_begin();
+  void frame_end();
+  void record(FramePhase phase, double seconds);
+  FrameCounters& counters() {
+    return counters_;
+  }
+
+private:
+  struct Samples {
+    std::vector<double> values;
+    std::size_t next = 0;
+    double last = 0;
+  };
+  std::size_t window_size;
+  std::array<Samples, FramePhaseCount> samples;
+  FrameCounters counters_;
+  std::size_t frame_count_ = 0;
+
+  clock_t::time_point frame_end_;
+  bool frame_ended_ = false;
+};
+
+} // namespace dgui
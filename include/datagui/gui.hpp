@@ -6,15 +6,22 @@
 #include "datagui/datapack/reader.hpp"
 #include "datagui/datapack/writer.hpp"
 #include "datagui/element/args.hpp"
+#include "datagui/element/hit_grid.hpp"
 #include "datagui/element/system.hpp"
 #include "datagui/element/tree.hpp"
+#include "datagui/frame_arena.hpp"
+#include "datagui/frame_stats.hpp"
 #include "datagui/theme.hpp"
+#include "datagui/thread_pool.hpp"
+#include "datagui/viewport/cached_layer.hpp"
 #include "datagui/viewport/canvas2d.hpp"
 #include "datagui/viewport/canvas3d.hpp"
 #include "datagui/viewport/plotter.hpp"
 #include "datagui/viewport/viewport.hpp"
 #include "datagui/visual/gui_renderer.hpp"
 #include "datagui/visual/window.hpp"
+#include <atomic>
+#include <list>
 #include <memory>
 #include <optional>
 #include <set>
@@ -37,11 +44,55 @@ public:
   void open(
       const std::string& title = "datagui",
       std::size_t width = 900,
-      std::size_t height = 600);
+      std::size_t height = 600,
+      WindowMode mode = WindowMode::Visible);
   void close();
 
   bool poll();
 
+  // For injecting input and reading back pixels in headless mode
+  Window& window() {
+    return window_;
+  }
+
+  // Idle mode
+  // When enabled, poll() only recalculates sizes and renders if something
+  // changed since the previous frame, otherwise it blocks for up to
+  // timeout seconds waiting for input before returning.
+  void idle_mode(bool enabled, double timeout = 0.5);
+
+  // Redraw on the next poll, for changes the gui can't detect itself
+  // (eg: viewport contents). Can be called from any thread.
+  void request_redraw();
+
+  // Parallel layout
+  // When at least min_elements need measuring, independent subtrees are
+  // measured on separate threads. Disabled with one thread, the default.
+  void parallel_layout(std::size_t threads, std::size_t min_elements = 1000);
+
+  // Cached groups
+  // Groups with args().cached() are rendered to textures using at most
+  // bytes of memory in total, evicting those drawn least recently. Groups
+  // which don't fit are rendered as usual.
+  void render_cache_limit(std::size_t bytes);
+
+  // Input recording and replay
+  // Recording captures the input received on each poll() until stopped.
+  // Replaying substitutes the recorded input for the window's, one recorded
+  // frame per poll(), without waiting for vsync or input. poll() returns false
+  // after the last frame.
+  void start_recording();
+  InputRecording stop_recording();
+  void start_replay(InputRecording input);
+  bool replaying() const {
+    return replaying_;
+  }
+
+  // Per-phase timings and counters, over recent frames
+  const FrameStats& frame_stats() const {
+    return frame_stats_;
+  }
+
   // Common end method
 
   void end();
@@ -98,6 +149,22 @@ public:
 
   void group();
 
+  // Memoized group
+  // Returns true if the contents must be defined, in which case end() must
+  // be called after, as for other containers. Returns false if the hash of
+  // the dependencies matches the previous frame and no element inside has
+  // received input since, in which case the existing contents are kept as
+  // they are and the calculated sizes of the contents are reused.
+  // Everything the contents depend on must be included in deps.
+  template <typename... Deps>
+  [[nodiscard]] bool memo(const Deps&... deps) {
+    std::size_t hash = 0;
+    ((hash ^= std::hash<Deps>{}(deps) + 0x9e3779b9 + (hash << 6) +
+              (hash >> 2)),
+     ...);
+    return memo_hash(hash);
+  }
+
   [[nodiscard]] bool popup(
       bool& open,
       const std::string& title,
@@ -130,6 +197,17 @@ public:
 
   void text_box(const std::string& text);
 
+  // A list of count rows with the given height, where only the rows in view
+  // are created. row(i) is called for each of these to define the contents
+  // of row i, within a horizontal group.
+  // As the list scrolls, the elements of rows leaving the view are reused
+  // for rows entering it, so values held by elements (eg: from checkbox()
+  // rather than checkbox_v()) need a key to stay with their row.
+  void virtual_list(
+      std::size_t count,
+      float row_height,
+      const std::function<void(std::size_t)>& row);
+
   template <typename T>
   T& variable(const T& initial_value = T()) {
     if (!var_current.valid()) {
@@ -215,6 +293,8 @@ public:
       return false;
     }
     edit_read(value, label);
+    // The reader consumes the changed flags, so as with consume()
+    redraw_ = true;
     current = current.next();
     end();
     return true;
@@ -257,14 +337,34 @@ private:
   }
 
   void move_down();
+  bool memo_hash(std::size_t deps_hash);
+  // Mark an element whose state was changed by input as dirty, and
+  // invalidate the memos containing it. Only called when the system reports
+  // a change, so eg: holding the mouse still doesn't dirty anything.
+  void input_received(ElementPtr element);
+
+  struct RenderCache {
+    ElementPtr element;
+    std::unique_ptr<CachedLayer> layer;
+    // Region of the window rendered to the layer, in whole pixels
+    Box2 box;
+    // Frames of the renderer it was last drawn on and rendered to on
+    std::size_t used_frame = 0;
+    std::size_t rendered_frame = 0;
+  };
 
   void render();
+  // Renders a cached group to its texture if anything in it changed since,
+  // or returns nullptr if it doesn't fit in the cache
+  RenderCache* render_cached(ElementPtr element);
+  void erase_render_cache(std::list<RenderCache>::iterator cache);
 #ifdef DGUI_DEBUG
   void debug_render();
 #endif
   void calculate_sizes();
 
-  void event_handling();
+  void event_handling(bool wait);
+  void replay_next();
   ElementPtr get_leaf_node(const Vec2& position);
   void event_handling_left_click(const MouseEvent& event);
   void event_handling_right_click(const MouseEvent& event);
@@ -279,7 +379,7 @@ private:
   requires std::is_base_of_v<Viewport, T>
   T& viewport(float width, float height);
 
-  Window window;
+  Window window_;
   Tree tree;
 
 #ifdef DGUI_DEBUG
@@ -288,9 +388,23 @@ private:
 
   std::shared_ptr<FontManager> fm;
   std::shared_ptr<Theme> theme;
+  // For data that only lives within poll(), reset at the start of each
+  std::shared_ptr<FrameArena> arena;
   GuiRenderer renderer;
   std::vector<std::unique_ptr<System>> systems;
 
+  // Renders cached groups, each to its own texture
+  GuiRenderer cache_renderer;
+  // Ordered from most to least recently used
+  std::list<RenderCache> render_caches;
+  std::unordered_map<
+      ElementPtr,
+      std::list<RenderCache>::iterator,
+      ElementPtr::HashFunc>
+      render_caches_by_element;
+  std::size_t render_cache_memory = 0;
+  std::size_t render_cache_limit_ = 64 << 20;
+
   std::stack<std::pair<ElementPtr, VarPtr>> stack;
   ElementPtr current;
   VarPtr var_current;
@@ -312,9 +426,39 @@ private:
 
   std::unordered_set<ElementPtr, ElementPtr::HashFunc> floating_elements;
   std::set<ElementPtr, ElementPtr::FloatCompare> ordered_floating_elements;
+  // For finding the element under the mouse, rebuilt on the first lookup
+  // after the layout changes or an element receives input
+  HitGrid hit_grid;
 
   Args args_;
 
+  bool idle_mode_ = false;
+  double idle_timeout_ = 0.5;
+  std::atomic_bool redraw_ = true;
+
+  std::unique_ptr<ThreadPool> layout_pool;
+  std::size_t parallel_layout_min_elements = 1000;
+
+  FrameStats frame_stats_;
+
+  bool recording_ = false;
+  InputRecording recording;
+  bool replaying_ = false;
+  InputRecording replay;
+  std::size_t replay_frame = 0;
+  std::size_t replay_index = 0;
+
+  // Clear a flag set by a system (eg: changed, released). Consuming a flag
+  // requests a redraw since the caller is likely to respond to it.
+  bool consume(bool& flag) {
+    if (!flag) {
+      return false;
+    }
+    flag = false;
+    redraw_ = true;
+    return true;
+  }
+
   // For convenience
   System& system(ConstElementPtr element) {
     return *systems[static_cast<std::size_t>(element.type())];
@@ -329,28 +473,44 @@ private:
     system(element).render(element, renderer);
   }
   void mouse_event(ElementPtr element, const MouseEvent& event) {
-    system(element).mouse_event(element, event);
+    if (system(element).mouse_event(element, event)) {
+      input_received(element);
+    }
   }
   void mouse_hover(ElementPtr element, const Vec2& mouse_pos) {
     system(element).mouse_hover(element, mouse_pos);
   }
   bool scroll_event(ElementPtr element, const ScrollEvent& event) {
-    return system(element).scroll_event(element, event);
+    if (!system(element).scroll_event(element, event)) {
+      return false;
+    }
+    input_received(element);
+    return true;
   }
   void key_event(ElementPtr element, const KeyEvent& event) {
-    system(element).key_event(element, event);
+    if (system(element).key_event(element, event)) {
+      input_received(element);
+    }
   }
   void text_event(ElementPtr element, const TextEvent& event) {
-    system(element).text_event(element, event);
+    if (system(element).text_event(element, event)) {
+      input_received(element);
+    }
   }
   void focus_enter(ElementPtr element) {
-    system(element).focus_enter(element);
+    if (system(element).focus_enter(element)) {
+      input_received(element);
+    }
   }
   void focus_leave(ElementPtr element, bool success) {
-    return system(element).focus_leave(element, success);
+    if (system(element).focus_leave(element, success)) {
+      input_received(element);
+    }
   }
   void focus_tree_leave(ElementPtr element) {
-    return system(element).focus_tree_leave(element);
+    if (system(element).focus_tree_leave(element)) {
+      input_received(element);
+    }
   }
 };
 
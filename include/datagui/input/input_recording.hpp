@@ -0,0 +1,60 @@
+#pragma once
+
+#include "datagui/input/event.hpp"
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace dgui {
+
+// Input received on a single frame, after processing by the window, so hold
+// events and double clicks replay exactly as recorded
+struct InputFrame {
+  std::size_t frame = 0;
+  Vec2 mouse_pos;
+  std::vector<MouseEvent> mouse_events;
+  std::vector<ScrollEvent> scroll_events;
+  std::vector<KeyEvent> key_events;
+  std::vector<TextEvent> text_events;
+
+  bool empty() const {
+    return mouse_events.empty() && scroll_events.empty() &&
+           key_events.empty() && text_events.empty();
+  }
+};
+
+// Only frames with events or a change in mouse position are stored
+class InputRecording {
+public:
+  InputRecording() : frame_count_(0) {}
+
+  // Append the input for the next frame
+  void push(const InputFrame& input);
+
+  // Recorded frames, in order of frame index
+  const std::vector<InputFrame>& frames() const {
+    return frames_;
+  }
+  // Total number of frames, including those without input
+  std::size_t frame_count() const {
+    return frame_count_;
+  }
+  void clear() {
+    frames_.clear();
+    frame_count_ = 0;
+  }
+
+  void write(std::ostream& os) const;
+  // Throws std::runtime_error if the data is invalid
+  void read(std::istream& is);
+
+  void save(const std::string& path) const;
+  void load(const std::string& path);
+
+private:
+  std::vector<InputFrame> frames_;
+  std::size_t frame_count_;
+};
+
+} // namespace dgui
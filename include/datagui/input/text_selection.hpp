@@ -51,6 +51,8 @@ struct TextSelection {
   std::size_t to() const {
     return std::max(begin, end);
   }
+
+  bool operator==(const TextSelection&) const = default;
 };
 
 enum class KeyValue { Backspace, LeftArrow, RightArrow, Enter };
@@ -14,15 +14,19 @@ struct LengthFixed {
   float value = 0;
   LengthFixed() = default;
   LengthFixed(float value) : value(value) {}
+  bool operator==(const LengthFixed&) const = default;
 };
 
 struct LengthDynamic {
   float weight = 1;
   LengthDynamic() = default;
   LengthDynamic(float weight) : weight(weight) {}
+  bool operator==(const LengthDynamic&) const = default;
 };
 
-struct LengthWrap {};
+struct LengthWrap {
+  bool operator==(const LengthWrap&) const = default;
+};
 
 using Length = std::variant<LengthFixed, LengthDynamic, LengthWrap>;
 
@@ -33,6 +37,7 @@ struct Layout {
   XAlignment x_alignment = XAlignment::Left;
   YAlignment y_alignment = YAlignment::Top;
   bool tight = false;
+  bool operator==(const Layout&) const = default;
 };
 
 struct InputSizes {
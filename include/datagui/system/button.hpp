@@ -13,8 +13,8 @@ public:
 
   void set_input_state(ElementPtr element) override;
   void render(ConstElementPtr element, GuiRenderer& renderer) override;
-  void mouse_event(ElementPtr element, const MouseEvent& event) override;
-  void key_event(ElementPtr element, const KeyEvent& event) override;
+  bool mouse_event(ElementPtr element, const MouseEvent& event) override;
+  bool key_event(ElementPtr element, const KeyEvent& event) override;
 
 private:
   std::shared_ptr<FontManager> fm;
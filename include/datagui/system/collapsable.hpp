@@ -1,6 +1,7 @@
 #pragma once
 
 #include "datagui/element/system.hpp"
+#include "datagui/frame_arena.hpp"
 #include "datagui/theme.hpp"
 #include "datagui/visual/font_manager.hpp"
 
@@ -10,19 +11,21 @@ class CollapsableSystem : public System {
 public:
   CollapsableSystem(
       std::shared_ptr<FontManager> fm,
-      std::shared_ptr<Theme> theme) :
-      fm(fm), theme(theme) {}
+      std::shared_ptr<Theme> theme,
+      std::shared_ptr<FrameArena> arena) :
+      fm(fm), theme(theme), arena(arena) {}
 
   void set_input_state(ElementPtr element) override;
   void set_dependent_state(ElementPtr element) override;
   void render(ConstElementPtr element, GuiRenderer& renderer) override;
-  void mouse_event(ElementPtr element, const MouseEvent& event) override;
+  bool mouse_event(ElementPtr element, const MouseEvent& event) override;
   bool scroll_event(ElementPtr element, const ScrollEvent& event) override;
-  void key_event(ElementPtr element, const KeyEvent& event) override;
+  bool key_event(ElementPtr element, const KeyEvent& event) override;
 
 private:
   std::shared_ptr<FontManager> fm;
   std::shared_ptr<Theme> theme;
+  std::shared_ptr<FrameArena> arena;
 };
 
 } // namespace dgui
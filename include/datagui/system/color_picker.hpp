@@ -14,8 +14,8 @@ public:
   void set_input_state(ElementPtr element) override;
   void set_dependent_state(ElementPtr element) override;
   void render(ConstElementPtr element, GuiRenderer& renderer) override;
-  void mouse_event(ElementPtr element, const MouseEvent& event) override;
-  void focus_tree_leave(ElementPtr element) override;
+  bool mouse_event(ElementPtr element, const MouseEvent& event) override;
+  bool focus_tree_leave(ElementPtr element) override;
 
 private:
   std::string get_slider_text(const Slider& slider) const;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "datagui/element/system.hpp"
+#include "datagui/frame_arena.hpp"
 #include "datagui/theme.hpp"
 
 namespace dgui {
@@ -9,22 +10,24 @@ class DropdownSystem : public System {
 public:
   DropdownSystem(
       std::shared_ptr<FontManager> fm,
-      std::shared_ptr<Theme> theme) :
-      fm(fm), theme(theme) {}
+      std::shared_ptr<Theme> theme,
+      std::shared_ptr<FrameArena> arena) :
+      fm(fm), theme(theme), arena(arena) {}
 
   void set_input_state(ElementPtr element) override;
   void set_dependent_state(ElementPtr element) override;
   void render(ConstElementPtr element, GuiRenderer& renderer) override;
-  void mouse_event(ElementPtr element, const MouseEvent& event) override;
+  bool mouse_event(ElementPtr element, const MouseEvent& event) override;
   bool scroll_event(ElementPtr element, const ScrollEvent& event) override;
-  void focus_enter(ElementPtr element) override;
-  void focus_tree_leave(ElementPtr element) override;
+  bool focus_enter(ElementPtr element) override;
+  bool focus_tree_leave(ElementPtr element) override;
 
 private:
   std::string get_slider_text(const Slider& slider) const;
 
   std::shared_ptr<FontManager> fm;
   std::shared_ptr<Theme> theme;
+  std::shared_ptr<FrameArena> arena;
 };
 
 } // namespace dgui
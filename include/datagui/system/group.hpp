@@ -1,13 +1,15 @@
 #pragma once
 
 #include "datagui/element/system.hpp"
+#include "datagui/frame_arena.hpp"
 #include "datagui/theme.hpp"
 
 namespace dgui {
 
 class GroupSystem : public System {
 public:
-  GroupSystem(std::shared_ptr<Theme> theme) : theme(theme) {}
+  GroupSystem(std::shared_ptr<Theme> theme, std::shared_ptr<FrameArena> arena) :
+      theme(theme), arena(arena) {}
 
   void set_input_state(ElementPtr element) override;
   void set_dependent_state(ElementPtr element) override;
@@ -16,6 +18,7 @@ public:
 
 private:
   std::shared_ptr<Theme> theme;
+  std::shared_ptr<FrameArena> arena;
 };
 
 } // namespace dgui
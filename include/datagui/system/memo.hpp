@@ -0,0 +1,23 @@
+#pragma once
+
+#include "datagui/element/system.hpp"
+#include "datagui/frame_arena.hpp"
+#include "datagui/theme.hpp"
+
+namespace dgui {
+
+class MemoSystem : public System {
+public:
+  MemoSystem(std::shared_ptr<Theme> theme, std::shared_ptr<FrameArena> arena) :
+      theme(theme), arena(arena) {}
+
+  void set_input_state(ElementPtr element) override;
+  void set_dependent_state(ElementPtr element) override;
+  void render(ConstElementPtr, GuiRenderer&) override {}
+
+private:
+  std::shared_ptr<Theme> theme;
+  std::shared_ptr<FrameArena> arena;
+};
+
+} // namespace dgui
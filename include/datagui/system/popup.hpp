@@ -1,24 +1,29 @@
 #pragma once
 
 #include "datagui/element/system.hpp"
+#include "datagui/frame_arena.hpp"
 #include "datagui/theme.hpp"
 
 namespace dgui {
 
 class PopupSystem : public System {
 public:
-  PopupSystem(std::shared_ptr<FontManager> fm, std::shared_ptr<Theme> theme) :
-      fm(fm), theme(theme) {}
+  PopupSystem(
+      std::shared_ptr<FontManager> fm,
+      std::shared_ptr<Theme> theme,
+      std::shared_ptr<FrameArena> arena) :
+      fm(fm), theme(theme), arena(arena) {}
 
   void set_input_state(ElementPtr element) override;
   void set_dependent_state(ElementPtr element) override;
   void render(ConstElementPtr element, GuiRenderer& renderer) override;
-  void mouse_event(ElementPtr element, const MouseEvent& event) override;
+  bool mouse_event(ElementPtr element, const MouseEvent& event) override;
   bool scroll_event(ElementPtr element, const ScrollEvent& event) override;
 
 private:
   std::shared_ptr<FontManager> fm;
   std::shared_ptr<Theme> theme;
+  std::shared_ptr<FrameArena> arena;
 };
 
 } // namespace dgui
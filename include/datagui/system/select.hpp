@@ -14,9 +14,9 @@ public:
   void set_input_state(ElementPtr element) override;
   void set_dependent_state(ElementPtr element) override;
   void render(ConstElementPtr element, GuiRenderer& renderer) override;
-  void mouse_event(ElementPtr element, const MouseEvent& event) override;
-  void focus_enter(ElementPtr element) override;
-  void focus_leave(ElementPtr element, bool success) override;
+  bool mouse_event(ElementPtr element, const MouseEvent& event) override;
+  bool focus_enter(ElementPtr element) override;
+  bool focus_leave(ElementPtr element, bool success) override;
 
 private:
   std::shared_ptr<FontManager> fm;
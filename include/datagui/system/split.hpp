@@ -12,7 +12,7 @@ public:
   void set_input_state(ElementPtr element) override;
   void set_dependent_state(ElementPtr element) override;
   void render(ConstElementPtr element, GuiRenderer& renderer) override;
-  void mouse_event(ElementPtr element, const MouseEvent& event) override;
+  bool mouse_event(ElementPtr element, const MouseEvent& event) override;
 
 private:
   std::shared_ptr<Theme> theme;
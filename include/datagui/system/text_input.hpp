@@ -16,13 +16,13 @@ public:
   void set_input_state(ElementPtr element) override;
   void render(ConstElementPtr element, GuiRenderer& renderer) override;
 
-  void mouse_event(ElementPtr element, const MouseEvent& event) override;
-  void key_event(ElementPtr element, const KeyEvent& event) override;
-  void text_event(ElementPtr element, const TextEvent& event) override;
+  bool mouse_event(ElementPtr element, const MouseEvent& event) override;
+  bool key_event(ElementPtr element, const KeyEvent& event) override;
+  bool text_event(ElementPtr element, const TextEvent& event) override;
   bool scroll_event(ElementPtr element, const ScrollEvent& event) override;
 
-  void focus_enter(ElementPtr element) override;
-  void focus_leave(ElementPtr element, bool success) override;
+  bool focus_enter(ElementPtr element) override;
+  bool focus_leave(ElementPtr element, bool success) override;
 
 private:
   std::shared_ptr<FontManager> fm;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "datagui/element/system.hpp"
+#include <array>
 
 namespace dgui {
 
@@ -9,8 +10,11 @@ public:
   ViewportPtrSystem() {}
   void set_input_state(ElementPtr element) override;
   void render(ConstElementPtr element, GuiRenderer& renderer) override;
-  void mouse_event(ElementPtr element, const MouseEvent& event) override;
+  bool mouse_event(ElementPtr element, const MouseEvent& event) override;
   bool scroll_event(ElementPtr element, const ScrollEvent& event) override;
+
+private:
+  std::array<Vec2, MouseButtonSize> hold_positions;
 };
 
 } // namespace dgui
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "datagui/element/system.hpp"
+#include "datagui/theme.hpp"
+
+namespace dgui {
+
+class VirtualListSystem : public System {
+public:
+  VirtualListSystem(std::shared_ptr<Theme> theme) : theme(theme) {}
+
+  void set_input_state(ElementPtr element) override;
+  void set_dependent_state(ElementPtr element) override;
+  void render(ConstElementPtr element, GuiRenderer& renderer) override;
+  bool scroll_event(ElementPtr element, const ScrollEvent& event) override;
+
+private:
+  std::shared_ptr<Theme> theme;
+};
+
+} // namespace dgui
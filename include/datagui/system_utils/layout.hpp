@@ -1,6 +1,7 @@
 #pragma once
 
 #include "datagui/element/tree.hpp"
+#include "datagui/frame_arena.hpp"
 #include "datagui/theme.hpp"
 #include "datagui/visual/gui_renderer.hpp"
 
@@ -9,6 +10,7 @@ namespace dgui {
 void layout_set_input_state(
     ElementPtr element,
     const std::shared_ptr<Theme>& theme,
+    FrameArena& arena,
     const Layout& layout,
     LayoutState& state);
 
@@ -16,6 +18,7 @@ void layout_set_dependent_state(
     ElementPtr element,
     const Box2& content_box,
     const std::shared_ptr<Theme>& theme,
+    FrameArena& arena,
     const Layout& layout,
     LayoutState& state);
 
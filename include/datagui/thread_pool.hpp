@@ -0,0 +1,60 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dgui {
+
+// Fixed set of threads for running batches of independent tasks.
+// Each thread has its own queue of tasks, and steals from the others once
+// its queue is empty, so tasks of uneven size still balance.
+class ThreadPool {
+public:
+  // The calling thread counts as one of the threads
+  ThreadPool(std::size_t threads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Calls task(i) for each i in [0, count) and waits for them to finish.
+  // If a task throws, the first exception is rethrown here.
+  void run(std::size_t count, const std::function<void(std::size_t)>& task);
+
+  std::size_t threads() const {
+    return queues.size();
+  }
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::size_t> tasks;
+  };
+
+  void worker(std::size_t queue);
+  void run_tasks(std::size_t queue);
+  // From the back of its own queue, otherwise the front of another
+  bool next_task(std::size_t queue, std::size_t& index);
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> workers;
+
+  std::mutex mutex;
+  std::condition_variable start_cv;
+  std::condition_variable done_cv;
+  const std::function<void(std::size_t)>* task = nullptr;
+  std::size_t batch = 0;
+  // Workers that haven't finished the current batch
+  std::size_t active = 0;
+  bool stopping = false;
+  std::exception_ptr error;
+};
+
+} // namespace dgui
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "datagui/viewport/viewport.hpp"
+
+namespace dgui {
+
+// Transparent texture a cached group's contents are rendered to, between
+// begin() and end(), to be drawn in their place until they change
+class CachedLayer : public Viewport {
+public:
+  CachedLayer() : Viewport(true) {}
+
+  void begin() override;
+  void end() override;
+
+  // RGBA8 texture and DEPTH24_STENCIL8 renderbuffer
+  static constexpr std::size_t bytes_per_pixel = 8;
+  std::size_t memory() const {
+    return std::size_t(viewport().area()) * bytes_per_pixel;
+  }
+
+private:
+  void impl_init(
+      const std::shared_ptr<Theme>&,
+      const std::shared_ptr<FontManager>&) override {}
+};
+
+} // namespace dgui
@@ -11,7 +11,9 @@ class FontManager;
 
 class Viewport {
 public:
-  Viewport();
+  // If transparent, the texture has an alpha channel, which is cleared with
+  // the alpha of the background color rather than opaque
+  Viewport(bool transparent = false);
   ~Viewport();
   Viewport(Viewport&&);
 
@@ -54,6 +56,8 @@ private:
   unsigned int texture_;
   unsigned int framebuffer;
   unsigned int render_buffer;
+  unsigned int prev_framebuffer;
+  bool transparent;
 };
 
 } // namespace dgui
@@ -3,6 +3,12 @@
 #include "datagui/font.hpp"
 #include "datagui/geometry.hpp"
 #include "datagui/layout.hpp"
+#include <array>
+#include <list>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
@@ -78,6 +84,9 @@ private:
   std::vector<Character> characters;
 };
 
+// Text measurement (text_size() and text_height()) is safe to call from
+// multiple threads. Anything else, which uses the font textures, must be
+// called from the thread with the GL context.
 class FontManager {
 public:
   const FontStructure& font_structure(Font font, int font_size);
@@ -94,14 +103,89 @@ public:
     Box2 pos;
     Box2 uv;
   };
-  std::vector<Character> text_characters(
+  std::pmr::vector<Character> text_characters(
       const std::string& text,
       Font font,
       int font_size,
-      Length width = LengthWrap());
+      Length width = LengthWrap(),
+      std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+  // Measured sizes and characters are cached, since most text is unchanged
+  // between frames. Past the capacity, the least recently used text is
+  // evicted.
+  struct TextCacheStats {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
+  };
+  TextCacheStats text_cache_stats();
+  void reset_text_cache_stats();
+  void set_text_cache_capacity(std::size_t capacity);
 
 private:
+  // Metrics only, without loading the font texture
+  FontStructure& font_metrics(Font font, int font_size);
+
+  struct TextKey {
+    std::size_t text_hash;
+    Font font;
+    int font_size;
+    float width; // Negative if not fixed
+    bool operator==(const TextKey&) const = default;
+
+    struct HashFunc {
+      std::size_t operator()(const TextKey& key) const {
+        std::size_t result = key.text_hash;
+        result ^= std::hash<int>()(int(key.font)) + (result << 6);
+        result ^= std::hash<int>()(key.font_size) + (result << 6);
+        result ^= std::hash<float>()(key.width) + (result << 6);
+        return result;
+      }
+    };
+  };
+  struct TextEntry {
+    TextKey key;
+    std::string text;
+    std::optional<Vec2> size;
+    std::optional<std::vector<Character>> characters;
+  };
+  // Split by key, so concurrent lookups rarely wait on the same lock
+  struct TextShard {
+    std::mutex mutex;
+    // Ordered from most to least recently used
+    std::list<TextEntry> entries;
+    std::unordered_map<
+        TextKey,
+        std::list<TextEntry>::iterator,
+        TextKey::HashFunc>
+        entries_by_key;
+    TextCacheStats stats;
+  };
+
+  static TextKey text_key(
+      const std::string& text,
+      Font font,
+      int font_size,
+      Length width);
+  TextShard& text_shard(const TextKey& key);
+
+  // With the shard locked
+  // Moves the entry to the front if found
+  TextEntry* find_text(
+      TextShard& shard,
+      const TextKey& key,
+      const std::string& text);
+  TextEntry& insert_text(
+      TextShard& shard,
+      const TextKey& key,
+      const std::string& text);
+  void evict_text(TextShard& shard);
+
+  std::shared_mutex fonts_mutex;
   std::unordered_map<std::pair<Font, int>, FontStructure> fonts;
+
+  std::array<TextShard, 16> text_shards;
+  std::size_t text_shard_capacity = 64;
 };
 
 } // namespace dgui
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "datagui/asset/image.hpp"
+#include "datagui/color.hpp"
+#include "datagui/frame_arena.hpp"
+#include "datagui/geometry.hpp"
+#include "datagui/visual/font_manager.hpp"
+#include "datagui/visual/render_stats.hpp"
+#include "datagui/visual/stream_buffer.hpp"
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dgui {
+
+// Draws boxes, text and images in the order they are queued, through a
+// single shader. Each primitive is an axis-aligned quad, clipped to its mask
+// on the CPU, and consecutive primitives are drawn together until the
+// textures they use don't fit in the available texture units.
+// All positions are Y up.
+//
+// Primitives queued during a frame are kept until the end of the next, so
+// a range of them can be replayed instead of queued again. A layer which
+// only replays everything it drew on the previous frame is drawn from the
+// buffer uploaded then, and only the region where the frame can differ from
+// the previous one needs drawing again.
+class GuiBatcher {
+public:
+  enum class Primitive {
+    Shape,
+    Glyph,
+    Image,
+    // Texture with premultiplied alpha, drawn to by this batcher
+    Cached,
+  };
+  static constexpr std::size_t primitive_count = 4;
+  // Textures bound per draw call
+  static constexpr std::size_t max_textures = 8;
+
+  // If given, the arena is used for temporary data while queueing text
+  void init(
+      const std::shared_ptr<FontManager>& fm,
+      const std::shared_ptr<FrameArena>& arena = nullptr);
+
+  void queue_masked_box(
+      const Box2& mask,
+      const Box2& box,
+      const Color& color,
+      float border_width = 0,
+      Color border_color = Color::Black(),
+      float radius = 0);
+
+  void queue_masked_text(
+      const Box2& mask,
+      const Vec2& origin,
+      const std::string& text,
+      Font font,
+      int font_size,
+      Color text_color,
+      Length width = LengthWrap());
+
+  void queue_masked_image(
+      const Box2& mask,
+      const Image& image,
+      const Vec2& position,
+      const Vec2& size);
+
+  void queue_viewport(const Box2& mask, const Box2& box, int texture);
+  void queue_cached(const Box2& mask, const Box2& box, int texture);
+
+  // Ends the layer of primitives queued since the previous call, drawn on
+  // top of the layers before it
+  void end_layer();
+  std::size_t layer_count() const {
+    return layer_index;
+  }
+  // Draws a layer ended this frame, limited to the scissor box
+  void draw(
+      std::size_t layer,
+      const Box2& viewport,
+      const Camera2d& camera,
+      const Box2& scissor);
+  // Starts a frame, keeping the primitives queued on the previous frame
+  void next_frame();
+
+  // Bounds of the primitives which weren't replayed in the same order, or
+  // which were drawn on the previous frame but not replayed, so outside of
+  // it the frame is drawn the same as the previous one. Images are always
+  // included, since their textures may be drawn to.
+  Box2 damage() const;
+
+  std::size_t frame() const {
+    return frame_;
+  }
+  // Primitives queued this frame, so [size() before, size() after) is the
+  // range of primitives queued in between
+  std::size_t size() const {
+    return instances.size();
+  }
+  // Queue a range of primitives from the previous frame again. Returns false
+  // if the range wasn't queued on the given frame.
+  bool replay(std::size_t frame, std::size_t begin, std::size_t end);
+  // If the primitives queued since queued_begin are the same as the range
+  // of the previous frame, replay the range instead, so they don't count as
+  // changed. Returns true if replayed.
+  bool replay_if_same(
+      std::size_t frame,
+      std::size_t begin,
+      std::size_t end,
+      std::size_t queued_begin);
+
+  const RenderStats& stats() const {
+    return stats_;
+  }
+  // Layers drawn without uploading, until reset
+  std::size_t layers_reused() const {
+    return layers_reused_;
+  }
+  // Primitives of the given type drawn, until reset
+  std::size_t primitives_drawn(Primitive primitive) const {
+    return primitives_drawn_[std::size_t(primitive)];
+  }
+  void reset_stats() {
+    stats_ = RenderStats();
+    primitives_drawn_ = {};
+    layers_reused_ = 0;
+  }
+
+private:
+  struct Instance {
+    Box2 box;
+    // Model coords [-0.5, 0.5] for shapes, or texture coords
+    Box2 coords;
+    Color color;
+    Color border_color;
+    // Normalized by the size of the unclipped box
+    Vec2 border_width;
+    Vec2 radius;
+    int primitive;
+    // Texture unit, assigned when drawn
+    int slot;
+  };
+  struct Batch {
+    std::size_t first;
+    std::size_t count;
+    std::array<unsigned int, max_textures> textures;
+    std::size_t texture_count;
+  };
+
+  // Drawn from its own buffer, so what it uploaded stays valid until it
+  // uploads again
+  struct Layer {
+    StreamBuffer buffer;
+    std::size_t offset = 0;
+    std::vector<Batch> batches;
+    // Range of the instances of the frame it was last ended on, with frame
+    // zero if they weren't uploaded
+    std::size_t frame = 0;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    // Replayed exactly the range uploaded on the previous frame
+    bool unchanged = false;
+  };
+
+  Instance& queue(Primitive primitive, unsigned int texture);
+
+  // Point the instance attributes at an offset into a buffer, with the VAO
+  // bound
+  void set_instance_attributes(unsigned int buffer, std::size_t offset);
+
+  std::shared_ptr<FontManager> fm;
+  std::shared_ptr<FrameArena> arena;
+
+  // Instances of the current and previous frame, across all layers
+  std::vector<Instance> instances;
+  std::vector<Instance> prev_instances;
+  // Texture of each instance, or 0 for shapes
+  std::vector<unsigned int> instance_textures;
+  std::vector<unsigned int> prev_instance_textures;
+  // Index of the previous frame's instance each instance replays, or
+  // no_source if queued this frame
+  static constexpr std::size_t no_source = -1;
+  std::vector<std::size_t> instance_sources;
+  std::size_t frame_ = 0;
+
+  std::vector<Layer> layers;
+  // Current layer, from layer_begin to the end of the instances
+  std::size_t layer_index = 0;
+  std::size_t layer_begin = 0;
+  // The current layer only contains a contiguous range of the previous
+  // frame's instances, replay_begin to replay_end, while it ends at
+  // replayed_size
+  std::size_t replayed_size = 0;
+  std::size_t replay_begin = 0;
+  std::size_t replay_end = 0;
+
+  // Shader
+  unsigned int program_id;
+
+  // Uniforms
+  unsigned int uniform_PV;
+
+  // Array/buffer objects
+  unsigned int VAO;
+  unsigned int static_VBO;
+  std::size_t static_vertex_count = 0;
+
+  RenderStats stats_;
+  std::array<std::size_t, primitive_count> primitives_drawn_ = {};
+  std::size_t layers_reused_ = 0;
+};
+
+} // namespace dgui
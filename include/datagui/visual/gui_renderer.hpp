@@ -2,9 +2,7 @@
 
 #include "datagui/geometry/camera.hpp"
 #include "datagui/visual/font_manager.hpp"
-#include "datagui/visual/image_shader.hpp"
-#include "datagui/visual/shape_2d_shader.hpp"
-#include "datagui/visual/text_2d_shader.hpp"
+#include "datagui/visual/gui_batcher.hpp"
 #include <assert.h>
 #include <memory>
 #include <stack>
@@ -13,7 +11,9 @@ namespace dgui {
 
 class GuiRenderer {
 public:
-  void init(std::shared_ptr<FontManager> fm);
+  void init(
+      std::shared_ptr<FontManager> fm,
+      std::shared_ptr<FrameArena> arena = nullptr);
 
   void queue_box(
       const Box2& box,
@@ -32,13 +32,71 @@ public:
 
   void queue_image(const Box2& box, const Image& image);
   void queue_viewport(const Box2& box, int texture);
+  // Texture drawn to by another GuiRenderer
+  void queue_cached(const Box2& box, int texture);
 
-  void begin(const Box2& viewport);
+  // Renders the given region of the window, to a framebuffer of its size.
+  // Unless keep_previous is set, the framebuffer isn't expected to hold the
+  // previous frame, so everything is drawn.
+  void begin(const Box2& viewport, bool keep_previous = true);
   void end();
 
-  void render();
+  // Ends the layer of everything queued since the previous call, drawn on
+  // top of the layers before it
+  void end_layer();
+  std::size_t layer_count() const {
+    return batcher.layer_count();
+  }
+  // Draws a layer after end(), limited to the damaged region
+  void render(std::size_t layer);
+
+  // Region in which the frame may differ from the previous one, in window
+  // coords rounded out to whole pixels, available after end(). The whole
+  // viewport if the viewport changed or the previous frame wasn't kept.
+  const Box2& damage() const {
+    return damage_;
+  }
+
+  // Retained rendering
+  // Commands queued on a frame can be queued again on the next with
+  // replay(), given the range between recorded() before and after queueing
+  // them, if the caller knows they haven't changed. Layers which only replay
+  // what they drew on the previous frame are drawn without uploading.
+  std::size_t frame() const {
+    return batcher.frame();
+  }
+  std::size_t recorded() const {
+    return batcher.size();
+  }
+  // Returns false if the commands must be queued again
+  bool replay(std::size_t frame, std::size_t begin, std::size_t end);
+  // Replays the range instead of the commands recorded since
+  // recorded_begin, if they are the same, so they don't count as changed
+  bool replay_if_same(
+      std::size_t frame,
+      std::size_t begin,
+      std::size_t end,
+      std::size_t recorded_begin);
+
   void push_mask(const Box2& mask);
   void pop_mask();
+  const Box2& mask() const {
+    assert(!masks.empty());
+    return masks.top();
+  }
+
+  const RenderStats& stats() const {
+    return batcher.stats();
+  }
+  std::size_t primitives_drawn(GuiBatcher::Primitive primitive) const {
+    return batcher.primitives_drawn(primitive);
+  }
+  std::size_t layers_reused() const {
+    return batcher.layers_reused();
+  }
+  void reset_stats() {
+    batcher.reset_stats();
+  }
 
 private:
   Box2 flip_box(const Box2& box);
@@ -46,10 +104,11 @@ private:
 
   Box2 viewport;
   Camera2d camera;
+  bool can_replay = false;
+  Box2 damage_;
 
-  Shape2dShader shape_shader;
-  Text2dShader text_shader;
-  ImageShader image_shader;
+  // Draws everything queued in order, so later elements are drawn on top
+  GuiBatcher batcher;
 
   std::shared_ptr<FontManager> fm;
   std::stack<Box2> masks;
@@ -3,6 +3,9 @@
 #include "datagui/asset/image.hpp"
 #include "datagui/geometry/box.hpp"
 #include "datagui/geometry/camera.hpp"
+#include "datagui/visual/render_stats.hpp"
+#include "datagui/visual/stream_buffer.hpp"
+#include <array>
 #include <memory>
 #include <vector>
 
@@ -41,6 +44,13 @@ public:
   void draw(const Box2& viewport, const Camera2d& camera);
   void clear();
 
+  const RenderStats& stats() const {
+    return stats_;
+  }
+  void reset_stats() {
+    stats_ = RenderStats();
+  }
+
 private:
   struct Vertex {
     Vec2 pos;
@@ -49,14 +59,17 @@ private:
   struct Command {
     Image image;
     int texture = 0; // Image or texture used
-    std::vector<Vertex> vertices;
+    // Two triangles, stored inline so queueing doesn't allocate
+    std::array<Vertex, 6> vertices;
   };
   std::vector<Command> commands;
 
   unsigned int program_id;
   unsigned int uniform_PV;
   unsigned int VAO;
-  unsigned int VBO;
+  StreamBuffer vertex_buffer;
+
+  RenderStats stats_;
 };
 
 } // namespace dgui
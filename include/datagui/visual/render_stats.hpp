@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+namespace dgui {
+
+// Accumulated by a shader over its draw() calls, until reset
+struct RenderStats {
+  std::size_t instances = 0;
+  std::size_t draw_calls = 0;
+  std::size_t bytes_uploaded = 0;
+  // Times the storage of a vertex buffer was orphaned or grown, which is
+  // once per buffer capacity of data uploaded, rather than once per draw
+  std::size_t buffer_allocations = 0;
+};
+
+} // namespace dgui
@@ -2,6 +2,8 @@
 
 #include "datagui/color.hpp"
 #include "datagui/geometry.hpp"
+#include "datagui/visual/render_stats.hpp"
+#include "datagui/visual/stream_buffer.hpp"
 #include <vector>
 
 namespace dgui {
@@ -59,6 +61,13 @@ public:
   void draw(const Box2& viewport, const Camera2d& camera);
   void clear();
 
+  const RenderStats& stats() const {
+    return stats_;
+  }
+  void reset_stats() {
+    stats_ = RenderStats();
+  }
+
 private:
   struct Element {
     Mat3 M;
@@ -70,6 +79,10 @@ private:
   };
   std::vector<Element> elements;
 
+  // Point the instance attributes at an offset into the instance buffer,
+  // with the VAO bound
+  void set_instance_attributes(std::size_t offset);
+
   // Shader
   unsigned int program_id;
 
@@ -79,8 +92,10 @@ private:
   // Array/buffer objects
   unsigned int VAO;
   unsigned int static_VBO;
-  unsigned int instance_VBO;
+  StreamBuffer instance_buffer;
   std::size_t static_vertex_count = 0;
+
+  RenderStats stats_;
 };
 
 } // namespace dgui
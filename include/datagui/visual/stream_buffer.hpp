@@ -0,0 +1,63 @@
+#pragma once
+
+#include "datagui/visual/render_stats.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dgui {
+
+// Vertex buffer for data written every frame. Each write is appended after
+// the previous one, so the GPU may still be reading earlier ranges while
+// the next is written, without synchronizing. Once full, the storage is
+// orphaned and reallocated, growing if needed, so it is reused across
+// frames rather than reallocated for every draw.
+class StreamBuffer {
+public:
+  StreamBuffer(std::size_t initial_capacity = 1 << 16);
+  ~StreamBuffer();
+  StreamBuffer(StreamBuffer&&);
+  StreamBuffer(const StreamBuffer&) = delete;
+  StreamBuffer& operator=(const StreamBuffer&) = delete;
+  StreamBuffer& operator=(StreamBuffer&&) = delete;
+
+  void init();
+
+  // Returns memory to write size bytes to, before calling unmap(). The
+  // range starts at offset(), a multiple of stride, so vertices can be
+  // drawn from offset() / stride.
+  // Leaves the buffer bound to GL_ARRAY_BUFFER.
+  void* map(std::size_t size, std::size_t stride, RenderStats& stats);
+  void unmap();
+  // Offset of the last mapped range, in bytes
+  std::size_t offset() const {
+    return offset_;
+  }
+
+  // Copies size bytes with map() and unmap(), returning the offset
+  std::size_t write(
+      const void* data,
+      std::size_t size,
+      std::size_t stride,
+      RenderStats& stats);
+
+  unsigned int id() const {
+    return VBO;
+  }
+  std::size_t capacity() const {
+    return capacity_;
+  }
+
+private:
+  unsigned int VBO;
+  std::size_t capacity_;
+  std::size_t offset_;
+  std::size_t size_;
+  // End of the last range written to the current storage
+  std::size_t end_;
+  // Used if mapping fails, and uploaded on unmap()
+  std::vector<std::uint8_t> fallback;
+  bool using_fallback;
+};
+
+} // namespace dgui
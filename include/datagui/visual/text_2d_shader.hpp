@@ -1,8 +1,13 @@
 #pragma once
 
 #include "datagui/color.hpp"
+#include "datagui/frame_arena.hpp"
 #include "datagui/geometry.hpp"
 #include "datagui/visual/font_manager.hpp"
+#include "datagui/visual/render_stats.hpp"
+#include "datagui/visual/stream_buffer.hpp"
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -10,22 +15,30 @@
 namespace dgui {
 
 class Text2dShader {
-  struct Vertex {
-    Vec2 pos;
-    Vec2 uv;
+  // One per glyph, expanded to a quad in the vertex shader, with corners
+  // position + x * axis_x + y * axis_y for x, y in [0, 1]
+  struct Glyph {
+    Vec2 position;
+    Vec2 axis_x;
+    Vec2 axis_y;
+    Box2 uv;
+    // RGBA, normalized in the shader
+    std::array<std::uint8_t, 4> color;
   };
 
-  struct CharList {
+  // Glyphs using the same font texture, drawn together
+  struct GlyphList {
     const unsigned int font_texture;
-    const Color font_color;
-    std::vector<Vertex> vertices;
+    std::vector<Glyph> glyphs;
 
-    CharList(unsigned int font_texture, const Color& font_color) :
-        font_texture(font_texture), font_color(font_color) {}
+    GlyphList(unsigned int font_texture) : font_texture(font_texture) {}
   };
 
 public:
-  void init(const std::shared_ptr<FontManager>& fm);
+  // If given, the arena is used for temporary data while queueing text
+  void init(
+      const std::shared_ptr<FontManager>& fm,
+      const std::shared_ptr<FrameArena>& arena = nullptr);
 
   void queue_masked_text(
       const Box2& mask,
@@ -49,24 +62,36 @@ public:
   void draw(const Box2& viewport, const Camera2d& camera);
   void clear();
 
+  const RenderStats& stats() const {
+    return stats_;
+  }
+  void reset_stats() {
+    stats_ = RenderStats();
+  }
+
 private:
-  std::vector<Vertex>& get_vertices(
-      Font font,
-      int font_size,
-      const Color& color);
+  std::vector<Glyph>& get_glyphs(Font font, int font_size);
+  // Point the instance attributes at an offset into the instance buffer,
+  // with the VAO bound
+  void set_instance_attributes(std::size_t offset);
 
   std::shared_ptr<FontManager> fm;
-  std::vector<CharList> char_lists;
+  std::shared_ptr<FrameArena> arena;
+  std::vector<GlyphList> glyph_lists;
 
   // Shader
   unsigned int program_id;
 
   // Uniforms
   unsigned int uniform_PV;
-  unsigned int uniform_text_color;
 
   // Array/buffer objects
-  unsigned int VAO, VBO;
+  unsigned int VAO;
+  unsigned int static_VBO;
+  StreamBuffer instance_buffer;
+  std::size_t static_vertex_count = 0;
+
+  RenderStats stats_;
 };
 
 } // namespace dgui
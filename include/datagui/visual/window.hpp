@@ -2,15 +2,26 @@
 
 #include "datagui/geometry.hpp"
 #include "datagui/input/event.hpp"
+#include "datagui/input/input_recording.hpp"
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <array>
 #include <chrono>
+#include <cstdint>
 #include <string>
 #include <vector>
 
 namespace dgui {
 
+enum class WindowMode {
+  Visible,
+  // Hidden window rendering to an offscreen framebuffer of fixed size, with
+  // input provided through the inject_* methods instead of the window system.
+  // If there is no display and glfw supports it, uses the null platform with
+  // an OSMesa context.
+  Headless,
+};
+
 class Window {
 public:
   Window();
@@ -19,11 +30,22 @@ public:
   void open(
       const std::string& title = "datagui",
       std::size_t width = 900,
-      std::size_t height = 600);
+      std::size_t height = 600,
+      WindowMode mode = WindowMode::Visible);
   void close();
 
+  WindowMode mode() const {
+    return mode_;
+  }
+
   bool running() const;
-  void render_begin();
+  // Frames are drawn to an offscreen framebuffer, kept between frames. If
+  // clear is false, the frame starts as the previous one was left, so only
+  // the regions cleared with clear(region) need to be drawn again. Its
+  // contents are undefined after a resize.
+  void render_begin(bool clear = true);
+  // Region in window coords, Y down
+  void clear(const Box2& region);
   void render_end();
 
   const Vec2& size() const {
@@ -34,8 +56,20 @@ public:
   }
   void set_fixed_size(const Vec2& size);
   void set_dynamic_size();
+  // Ignored in headless mode, where vsync is always disabled
+  void set_vsync(bool enabled);
 
   void poll_events();
+  // Block until an event arrives or timeout (seconds) elapses
+  void wait_events(double timeout);
+  // Wake a thread blocked in wait_events(), safe to call from any thread
+  void wake();
+
+  // True if the last poll/wait received input or the window was resized,
+  // excluding the hold events generated for held mouse buttons
+  bool has_input() const {
+    return has_input_;
+  }
 
   const std::vector<MouseEvent>& mouse_events() const {
     return mouse_events_;
@@ -53,13 +87,51 @@ public:
     return mouse_pos_;
   }
 
+  // Input injection for headless mode, received on the next poll/wait
+  void inject_mouse_pos(const Vec2& mouse_pos);
+  void inject_mouse_button(MouseButton button, MouseAction action);
+  void inject_scroll(float amount);
+  void inject_key(Key key, KeyAction action);
+  void inject_text(char value);
+  void inject_modifiers(const Modifiers& mod);
+
+  // Input received on the last poll/wait
+  InputFrame input() const;
+  // Replace the input received on the last poll/wait, for replaying
+  void replay_input(const InputFrame& input);
+
+  // Makes running() return false
+  void request_close();
+
+  // RGBA pixels of the last rendered frame, top row first
+  std::vector<std::uint8_t> read_pixels() const;
+
 private:
+  void clear_events();
+  void process_events();
+  void resize_offscreen();
+
   std::string title;
   std::size_t default_width;
   std::size_t default_height;
 
   GLFWwindow* window;
   Vec2 size_;
+  WindowMode mode_;
+
+  // Drawn to in both modes, and copied to the window when visible
+  unsigned int offscreen_framebuffer;
+  unsigned int offscreen_color;
+  unsigned int offscreen_depth;
+  Vec2 offscreen_size;
+
+  // Headless mode only
+  std::vector<MouseEvent> injected_mouse_events;
+  std::vector<ScrollEvent> injected_scroll_events;
+  std::vector<KeyEvent> injected_key_events;
+  std::vector<TextEvent> injected_text_events;
+  Vec2 injected_mouse_pos;
+  Modifiers injected_mod;
 
   std::vector<MouseEvent> mouse_events_;
   std::vector<ScrollEvent> scroll_events_;
@@ -69,6 +141,7 @@ private:
   std::array<Vec2, MouseButtonSize> mouse_down_position_;
   std::array<Modifiers, MouseButtonSize> mouse_down_mod_;
   Vec2 mouse_pos_;
+  bool has_input_;
 
   static constexpr double double_click_time = 0.3;
   std::array<std::chrono::high_resolution_clock::time_point, 3>
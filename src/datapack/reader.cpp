@@ -51,8 +51,8 @@ void GuiReader::number(dpack::NumberType type, void* value) {
   if (hint_range) {
     node.expect(Type::Slider, read_id());
     auto& slider = node.slider();
-    slider.lower = hint_range->lower;
-    slider.upper = hint_range->upper;
+    update(node, slider.lower, double(hint_range->lower));
+    update(node, slider.upper, double(hint_range->upper));
     slider.type = convert_type(type);
 
     changed_ |= slider.changed;
@@ -161,15 +161,16 @@ bool GuiReader::optional_begin() {
 
   node.expect(Type::Group);
   {
-    auto& group = node.group();
-    group.layout.rows = 1;
-    group.layout.cols = 2;
-    group.layout.tight = true;
+    Layout layout;
+    layout.rows = 1;
+    layout.cols = 2;
+    layout.tight = true;
+    update(node, node.group().layout, layout);
   }
   node = node.child();
 
   node.expect(Type::TextBox);
-  node.text_box().text = "Has value?";
+  update(node, node.text_box().text, std::string("Has value?"));
   node = node.next();
 
   bool has_value;
@@ -183,7 +184,7 @@ bool GuiReader::optional_begin() {
 
   node = node.parent().next();
   if (node) {
-    node.state().force_hidden = !has_value;
+    update(node, node.state().force_hidden, !has_value);
   }
 
   if (!has_value) {
@@ -207,10 +208,7 @@ int GuiReader::variant_begin(const std::span<const char*>& labels) {
   auto& select = node.select();
   changed_ |= select.changed;
   select.changed = false;
-  select.choices.clear();
-  for (auto label : labels) {
-    node.select().choices.emplace_back(label);
-  }
+  update(node, select.choices, {labels.begin(), labels.end()});
   if (is_new) {
     // Always set default value to 0
     select.choice = 0;
@@ -219,11 +217,11 @@ int GuiReader::variant_begin(const std::span<const char*>& labels) {
   int choice = select.choice;
   node = node.next();
   while (node && node.id() != choice) {
-    node.state().force_hidden = true;
+    update(node, node.state().force_hidden, true);
     node = node.next();
   }
   if (node) {
-    node.state().force_hidden = false;
+    update(node, node.state().force_hidden, false);
   }
   next_id_ = choice;
 
@@ -236,7 +234,7 @@ void GuiReader::variant_end() {
   if (node) {
     node = node.next();
     while (node) {
-      node.state().force_hidden = true;
+      update(node, node.state().force_hidden, true);
       node = node.next();
     }
   }
@@ -331,10 +329,11 @@ size_t GuiReader::list_begin() {
 
   // Enter items group
   node.expect(Type::Group);
-  auto& group = node.group();
-  group.layout.tight = true;
-  group.layout.rows = -1;
-  group.layout.cols = 3;
+  Layout layout;
+  layout.tight = true;
+  layout.rows = -1;
+  layout.cols = 3;
+  update(node, node.group().layout, layout);
   node = node.child();
 
   at_object_begin = true;
@@ -380,7 +379,7 @@ void GuiReader::list_end() {
   node = node.parent().next();
   node.expect(Type::Button);
   auto& button = node.button();
-  button.text = "Add";
+  update(node, button.text, std::string("Add"));
   if (button.released) {
     // Set changed = true on the next poll()
     button.released = false;
@@ -418,7 +417,10 @@ void GuiReader::list_item_label() {
   }
 
   node.expect(Type::TextBox, expected_id);
-  node.text_box().text = "Item " + std::to_string(list_state.pos);
+  update(
+      node,
+      node.text_box().text,
+      "Item " + std::to_string(list_state.pos));
 }
 
 bool GuiReader::list_remove_button() {
@@ -426,7 +428,7 @@ bool GuiReader::list_remove_button() {
 
   node.expect(Type::Button);
   auto& button = node.button();
-  button.text = "Remove";
+  update(node, button.text, std::string("Remove"));
   if (button.released) {
     // Set changed = true on the next poll()
     button.released = false;
@@ -442,7 +444,7 @@ void GuiReader::enter_primitive() {
     is_root_ = false;
     node.expect(Type::Group);
     root = node;
-    node.group().layout.tight = true;
+    update(node, node.group().layout.tight, true);
     node = node.child();
     return;
   }
@@ -451,7 +453,7 @@ void GuiReader::enter_primitive() {
   in_composite_ = false;
   if (!next_label_.empty()) {
     node.expect(Type::TextBox);
-    node.text_box().text = next_label_;
+    update(node, node.text_box().text, next_label_);
     node = node.next();
   }
   next_label_.clear();
@@ -462,22 +464,23 @@ void GuiReader::enter_container(size_t rows, size_t cols) {
     assert(!is_root_);
     in_composite_ = false;
     node.expect(Type::Group, read_id());
-    auto& group = node.group();
-    group.layout.tight = true;
-    group.layout.rows = rows;
-    group.layout.cols = cols;
+    Layout layout;
+    layout.tight = true;
+    layout.rows = rows;
+    layout.cols = cols;
+    update(node, node.group().layout, layout);
     node = node.child();
     return;
   }
 
   node.expect(Type::Collapsable, read_id());
   auto& collapsable = node.collapsable();
-  collapsable.label = next_label_;
-  collapsable.layout.rows = rows;
-  collapsable.layout.cols = cols;
+  update(node, collapsable.label, next_label_);
+  update(node, collapsable.layout.rows, int(rows));
+  update(node, collapsable.layout.cols, int(cols));
 
   if (!next_label_.empty() && !is_root_) {
-    node.state().num_cells = 2;
+    update(node, node.state().num_cells, 2);
   }
   next_label_.clear();
   if (is_root_) {
@@ -53,33 +53,35 @@ void GuiWriter::number(dpack::NumberType type, const void* value) {
   if (hint_range) {
     node.expect(Type::Slider, read_id());
     auto& slider = node.slider();
-    slider.lower = hint_range->lower;
-    slider.upper = hint_range->upper;
+    update(node, slider.lower, double(hint_range->lower));
+    update(node, slider.upper, double(hint_range->upper));
     slider.type = convert_type(type);
 
+    double slider_value = 0;
     switch (type) {
     case dpack::NumberType::I32:
-      slider.value = *(const std::int32_t*)value;
+      slider_value = *(const std::int32_t*)value;
       break;
     case dpack::NumberType::I64:
-      slider.value = *(const std::int64_t*)value;
+      slider_value = *(const std::int64_t*)value;
       break;
     case dpack::NumberType::U32:
-      slider.value = *(const std::uint32_t*)value;
+      slider_value = *(const std::uint32_t*)value;
       break;
     case dpack::NumberType::U64:
-      slider.value = *(const std::uint64_t*)value;
+      slider_value = *(const std::uint64_t*)value;
       break;
     case dpack::NumberType::U8:
-      slider.value = *(const std::uint8_t*)value;
+      slider_value = *(const std::uint8_t*)value;
       break;
     case dpack::NumberType::F32:
-      slider.value = *(const float*)value;
+      slider_value = *(const float*)value;
       break;
     case dpack::NumberType::F64:
-      slider.value = *(const double*)value;
+      slider_value = *(const double*)value;
       break;
     }
+    update(node, slider.value, slider_value);
     slider.changed = false;
     return;
   }
@@ -87,29 +89,31 @@ void GuiWriter::number(dpack::NumberType type, const void* value) {
   node.expect(Type::TextInput, read_id());
   auto& text_input = node.text_input();
 
+  std::string text;
   switch (type) {
   case dpack::NumberType::I32:
-    text_input.text = number_to_string(*(const std::int32_t*)value);
+    text = number_to_string(*(const std::int32_t*)value);
     break;
   case dpack::NumberType::I64:
-    text_input.text = number_to_string(*(const std::int64_t*)value);
+    text = number_to_string(*(const std::int64_t*)value);
     break;
   case dpack::NumberType::U32:
-    text_input.text = number_to_string(*(const std::uint32_t*)value);
+    text = number_to_string(*(const std::uint32_t*)value);
     break;
   case dpack::NumberType::U64:
-    text_input.text = number_to_string(*(const std::uint64_t*)value);
+    text = number_to_string(*(const std::uint64_t*)value);
     break;
   case dpack::NumberType::U8:
-    text_input.text = number_to_string(*(const std::uint8_t*)value);
+    text = number_to_string(*(const std::uint8_t*)value);
     break;
   case dpack::NumberType::F32:
-    text_input.text = number_to_string(*(const float*)value);
+    text = number_to_string(*(const float*)value);
     break;
   case dpack::NumberType::F64:
-    text_input.text = number_to_string(*(const double*)value);
+    text = number_to_string(*(const double*)value);
     break;
   }
+  update(node, text_input.text, text);
   text_input.changed = false;
 }
 
@@ -117,7 +121,7 @@ void GuiWriter::boolean(bool value) {
   enter_primitive();
   node.expect(Type::Checkbox, read_id());
   auto& checkbox = node.checkbox();
-  checkbox.checked = value;
+  update(node, checkbox.checked, value);
   checkbox.changed = false;
 }
 
@@ -125,7 +129,7 @@ void GuiWriter::string(const char* value) {
   enter_primitive();
   node.expect(Type::TextInput, read_id());
   auto& text_input = node.text_input();
-  text_input.text = value;
+  update(node, text_input.text, std::string(value));
   text_input.changed = false;
 }
 
@@ -133,11 +137,8 @@ void GuiWriter::enumerate(int value, const std::span<const char*>& labels) {
   enter_primitive();
   node.expect(Type::Select, read_id());
   auto& select = node.select();
-  select.choices.clear();
-  for (auto label : labels) {
-    select.choices.emplace_back(label);
-  }
-  select.choice = value;
+  update(node, select.choices, {labels.begin(), labels.end()});
+  update(node, select.choice, value);
   select.changed = false;
 }
 
@@ -145,7 +146,7 @@ void GuiWriter::binary(const std::span<const std::uint8_t>& data) {
   enter_primitive();
   node.expect(Type::TextInput, read_id());
   auto& text_input = node.text_input();
-  text_input.text = dpack::base64_encode(data);
+  update(node, text_input.text, dpack::base64_encode(data));
   text_input.changed = false;
 }
 
@@ -154,27 +155,28 @@ void GuiWriter::optional_begin(bool has_value) {
 
   node.expect(Type::Group);
   {
-    auto& group = node.group();
-    group.layout.rows = 1;
-    group.layout.cols = 2;
-    group.layout.tight = true;
+    Layout layout;
+    layout.rows = 1;
+    layout.cols = 2;
+    layout.tight = true;
+    update(node, node.group().layout, layout);
   }
   node = node.child();
 
   node.expect(Type::TextBox);
-  node.text_box().text = "Has value?";
+  update(node, node.text_box().text, std::string("Has value?"));
   node = node.next();
 
   node.expect(Type::Checkbox);
   {
     auto& checkbox = node.checkbox();
-    checkbox.checked = has_value;
+    update(node, checkbox.checked, has_value);
     checkbox.changed = false;
   }
 
   node = node.parent().next();
   if (node) {
-    node.state().force_hidden = !has_value;
+    update(node, node.state().force_hidden, !has_value);
   }
 
   if (!has_value) {
@@ -198,20 +200,17 @@ void GuiWriter::variant_begin(
 
   node.expect(Type::Select, read_id());
   auto& select = node.select();
-  select.choices.clear();
-  for (auto label : labels) {
-    select.choices.emplace_back(label);
-  }
-  select.choice = value;
+  update(node, select.choices, {labels.begin(), labels.end()});
+  update(node, select.choice, value);
   select.changed = false;
 
   node = node.next();
   while (node && node.id() != value) {
-    node.state().force_hidden = true;
+    update(node, node.state().force_hidden, true);
     node = node.next();
   }
   if (node) {
-    node.state().force_hidden = false;
+    update(node, node.state().force_hidden, false);
   }
   next_id_ = value;
 
@@ -223,7 +222,7 @@ void GuiWriter::variant_end() {
   if (node) {
     node = node.next();
     while (node) {
-      node.state().force_hidden = true;
+      update(node, node.state().force_hidden, true);
       node = node.next();
     }
   }
@@ -263,7 +262,7 @@ void GuiWriter::object_end() {
   if (in_color) {
     assert(color_i == 4);
     auto& color_picker = node.color_picker();
-    color_picker.value = color;
+    update(node, color_picker.value, color);
     color_picker.changed = false;
     in_color = false;
     return;
@@ -331,10 +330,11 @@ void GuiWriter::list_begin(size_t size) {
 
   // Enter items group
   node.expect(Type::Group);
-  auto& group = node.group();
-  group.layout.tight = true;
-  group.layout.rows = -1;
-  group.layout.cols = 3;
+  Layout layout;
+  layout.tight = true;
+  layout.rows = -1;
+  layout.cols = 3;
+  update(node, node.group().layout, layout);
   node = node.child();
 
   at_object_begin = true;
@@ -374,7 +374,7 @@ void GuiWriter::list_end() {
 
   node = node.parent().next();
   node.expect(Type::Button);
-  node.button().text = "Add";
+  update(node, node.button().text, std::string("Add"));
 
   list_stack.pop();
   assert(!node.next());
@@ -391,12 +391,15 @@ void GuiWriter::list_item_label() {
   }
 
   node.expect(Type::TextBox, expected_id);
-  node.text_box().text = "Item " + std::to_string(list_state.pos);
+  update(
+      node,
+      node.text_box().text,
+      "Item " + std::to_string(list_state.pos));
 }
 
 void GuiWriter::list_remove_button() {
   node.expect(Type::Button);
-  node.button().text = "Remove";
+  update(node, node.button().text, std::string("Remove"));
 }
 
 void GuiWriter::enter_primitive() {
@@ -404,7 +407,7 @@ void GuiWriter::enter_primitive() {
     is_root_ = false;
     node.expect(Type::Group);
     root = node;
-    node.group().layout.tight = true;
+    update(node, node.group().layout.tight, true);
     node = node.child();
     return;
   }
@@ -413,7 +416,7 @@ void GuiWriter::enter_primitive() {
   in_composite_ = false;
   if (!next_label_.empty()) {
     node.expect(Type::TextBox);
-    node.text_box().text = next_label_;
+    update(node, node.text_box().text, next_label_);
     node = node.next();
   }
   next_label_.clear();
@@ -424,22 +427,23 @@ void GuiWriter::enter_container(size_t rows, size_t cols) {
     assert(!is_root_);
     in_composite_ = false;
     node.expect(Type::Group, read_id());
-    auto& group = node.group();
-    group.layout.tight = true;
-    group.layout.rows = rows;
-    group.layout.cols = cols;
+    Layout layout;
+    layout.tight = true;
+    layout.rows = rows;
+    layout.cols = cols;
+    update(node, node.group().layout, layout);
     node = node.child();
     return;
   }
 
   node.expect(Type::Collapsable, read_id());
   auto& collapsable = node.collapsable();
-  collapsable.label = next_label_;
-  collapsable.layout.rows = rows;
-  collapsable.layout.cols = cols;
+  update(node, collapsable.label, next_label_);
+  update(node, collapsable.layout.rows, int(rows));
+  update(node, collapsable.layout.cols, int(cols));
 
   if (!next_label_.empty() && !is_root_) {
-    node.state().num_cells = 2;
+    update(node, node.state().num_cells, 2);
   }
   if (is_root_) {
     is_root_ = false;
@@ -4,12 +4,13 @@
 namespace dgui {
 
 void Args::apply(ElementPtr element) {
-  num_cells_.consume(element.state().num_cells);
+  bool changed = false;
+  changed |= num_cells_.consume(element.state().num_cells);
   switch (element.type()) {
   case Type::Button: {
     auto& button = element.button();
-    text_size_.consume(button.text_size);
-    text_color_.consume(button.text_color);
+    changed |= text_size_.consume(button.text_size);
+    changed |= text_color_.consume(button.text_color);
     break;
   }
   case Type::Checkbox: {
@@ -17,41 +18,47 @@ void Args::apply(ElementPtr element) {
   }
   case Type::Collapsable: {
     auto& collapsable = element.collapsable();
-    header_color_.consume(collapsable.header_color);
-    bg_color_.consume(collapsable.bg_color);
-    border_.consume(collapsable.border);
-    layout_.consume(collapsable.layout);
-    width_.consume(collapsable.width);
-    height_.consume(collapsable.height);
+    changed |= header_color_.consume(collapsable.header_color);
+    changed |= bg_color_.consume(collapsable.bg_color);
+    changed |= border_.consume(collapsable.border);
+    changed |= layout_.consume(collapsable.layout);
+    changed |= width_.consume(collapsable.width);
+    changed |= height_.consume(collapsable.height);
     break;
   }
   case Type::ColorPicker: {
     auto& color_picker = element.color_picker();
-    always_.consume(color_picker.always);
+    changed |= always_.consume(color_picker.always);
     break;
   }
   case Type::Dropdown: {
     auto& dropdown = element.dropdown();
-    layout_.consume(dropdown.layout);
-    retain_.consume(dropdown.retain);
-    dropdown_direction_.consume(dropdown.direction);
+    changed |= layout_.consume(dropdown.layout);
+    changed |= retain_.consume(dropdown.retain);
+    changed |= dropdown_direction_.consume(dropdown.direction);
     break;
   }
   case Type::Group: {
     auto& group = element.group();
-    bg_color_.consume(group.bg_color);
-    border_.consume(group.border);
-    layout_.consume(group.layout);
-    width_.consume(group.width);
-    height_.consume(group.height);
+    changed |= bg_color_.consume(group.bg_color);
+    changed |= border_.consume(group.border);
+    changed |= layout_.consume(group.layout);
+    changed |= width_.consume(group.width);
+    changed |= height_.consume(group.height);
+    changed |= cached_.consume(group.cached);
+    break;
+  }
+  case Type::Memo: {
+    auto& memo = element.memo();
+    changed |= layout_.consume(memo.layout);
     break;
   }
   case Type::Popup: {
     auto& popup = element.popup();
-    header_color_.consume(popup.header_color);
-    bg_color_.consume(popup.bg_color);
-    layout_.consume(popup.layout);
-    retain_.consume(popup.retain);
+    changed |= header_color_.consume(popup.header_color);
+    changed |= bg_color_.consume(popup.bg_color);
+    changed |= layout_.consume(popup.layout);
+    changed |= retain_.consume(popup.retain);
     break;
   }
   case Type::Select: {
@@ -59,15 +66,15 @@ void Args::apply(ElementPtr element) {
   }
   case Type::Slider: {
     auto& slider = element.slider();
-    always_.consume(slider.always);
-    slider_length_.consume(slider.length);
+    changed |= always_.consume(slider.always);
+    changed |= slider_length_.consume(slider.length);
     break;
   }
   case Type::Split: {
     auto& split = element.split();
-    split_fixed_.consume(split.fixed);
-    width_.consume(split.width);
-    height_.consume(split.height);
+    changed |= split_fixed_.consume(split.fixed);
+    changed |= width_.consume(split.width);
+    changed |= height_.consume(split.height);
     break;
   }
   case Type::Tabs: {
@@ -75,18 +82,27 @@ void Args::apply(ElementPtr element) {
   }
   case Type::TextBox: {
     auto& text_box = element.text_box();
-    text_size_.consume(text_box.text_size);
-    text_color_.consume(text_box.text_color);
+    changed |= text_size_.consume(text_box.text_size);
+    changed |= text_color_.consume(text_box.text_color);
     break;
   }
   case Type::TextInput: {
     auto& text_input = element.text_input();
-    text_input_width_.consume(text_input.width);
+    changed |= text_input_width_.consume(text_input.width);
     break;
   }
   case Type::ViewportPtr: {
     break;
   }
+  case Type::VirtualList: {
+    auto& virtual_list = element.virtual_list();
+    changed |= width_.consume(virtual_list.width);
+    changed |= height_.consume(virtual_list.height);
+    break;
+  }
+  }
+  if (changed) {
+    element.set_dirty();
   }
 }
 
@@ -0,0 +1,180 @@
+#include "datagui/element/hit_grid.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace dgui {
+
+void HitGrid::build(ElementPtr root, const Box2& bounds) {
+  this->bounds = bounds;
+  Vec2 size = bounds.size();
+  cells_x = std::max<std::size_t>(std::ceil(size.x / cell_size), 1);
+  cells_y = std::max<std::size_t>(std::ceil(size.y / cell_size), 1);
+  valid_ = true;
+
+  entries.clear();
+  floating_entries.clear();
+  cell_begin.assign(cells_x * cells_y + 1, 0);
+  cell_entries.clear();
+  if (!root) {
+    return;
+  }
+
+  // Cells overlapped by each entry, as [lower, upper]
+  struct CellRange {
+    std::size_t lower_x;
+    std::size_t lower_y;
+    std::size_t upper_x;
+    std::size_t upper_y;
+  };
+  std::vector<CellRange> cell_ranges;
+
+  auto to_cell = [&](float value, float lower, std::size_t cells) {
+    float cell = std::floor((value - lower) / cell_size);
+    return std::size_t(std::clamp<float>(cell, 0, cells - 1));
+  };
+
+  struct Item {
+    ElementPtr element;
+    int parent;
+    // Region which the element must overlap to be hit through its parent
+    Box2 clip;
+  };
+  std::vector<Item> stack;
+  stack.push_back({root, -1, bounds});
+
+  // Pre-order, visiting children in order, so the first child containing a
+  // point is found first
+  while (!stack.empty()) {
+    Item item = stack.back();
+    stack.pop_back();
+    const auto& state = item.element.state();
+    if (state.hidden) {
+      continue;
+    }
+
+    Entry entry;
+    entry.element = item.element;
+    entry.parent = item.parent;
+    entry.end = entries.size() + 1;
+    entry.has_box = !state.float_only;
+    entry.box = state.box();
+    entry.has_float_box = state.floating;
+    if (state.floating) {
+      entry.float_box = item.element.cold_state().float_box;
+    }
+
+    // A floating element is also hit from itself, regardless of its parent
+    Box2 clip = state.floating ? bounds : item.clip;
+    if (entry.has_box && entry.has_float_box) {
+      clip = intersection(clip, bounding(entry.box, entry.float_box));
+    } else if (entry.has_box) {
+      clip = intersection(clip, entry.box);
+    } else if (entry.has_float_box) {
+      clip = intersection(clip, entry.float_box);
+    } else {
+      clip = Box2();
+    }
+    // Also false for NaN
+    bool hit = clip.lower.x < clip.upper.x && clip.lower.y < clip.upper.y;
+
+    int index = -1;
+    if (hit) {
+      index = entries.size();
+      entries.push_back(entry);
+      cell_ranges.push_back(
+          {to_cell(clip.lower.x, bounds.lower.x, cells_x),
+           to_cell(clip.lower.y, bounds.lower.y, cells_y),
+           to_cell(clip.upper.x, bounds.lower.x, cells_x),
+           to_cell(clip.upper.y, bounds.lower.y, cells_y)});
+      if (state.floating) {
+        floating_entries.emplace(item.element, index);
+      }
+    } else if (!state.contains_floating) {
+      // Nothing below can be hit either
+      continue;
+    }
+
+    for (auto child = item.element.last_child(); child; child = child.prev()) {
+      stack.push_back({child, index, clip});
+    }
+  }
+
+  // Children come after their parent, so iterating backwards gives the end
+  // of each subtree
+  for (int i = entries.size() - 1; i >= 0; i--) {
+    int parent = entries[i].parent;
+    if (parent != -1) {
+      entries[parent].end = std::max(entries[parent].end, entries[i].end);
+    }
+  }
+
+  for (const auto& range : cell_ranges) {
+    for (std::size_t y = range.lower_y; y <= range.upper_y; y++) {
+      for (std::size_t x = range.lower_x; x <= range.upper_x; x++) {
+        cell_begin[y * cells_x + x + 1]++;
+      }
+    }
+  }
+  for (std::size_t i = 1; i < cell_begin.size(); i++) {
+    cell_begin[i] += cell_begin[i - 1];
+  }
+  cell_entries.resize(cell_begin.back());
+  std::vector<std::size_t> cell_end(cell_begin.begin(), cell_begin.end() - 1);
+  for (std::size_t i = 0; i < cell_ranges.size(); i++) {
+    const auto& range = cell_ranges[i];
+    for (std::size_t y = range.lower_y; y <= range.upper_y; y++) {
+      for (std::size_t x = range.lower_x; x <= range.upper_x; x++) {
+        cell_entries[cell_end[y * cells_x + x]++] = i;
+      }
+    }
+  }
+}
+
+std::optional<ElementPtr> HitGrid::find(
+    ElementPtr root,
+    const Vec2& position) const {
+  if (!bounds.contains(position)) {
+    return std::nullopt;
+  }
+
+  int root_entry = -1;
+  if (!entries.empty() && entries[0].element == root) {
+    root_entry = 0;
+  } else if (auto iter = floating_entries.find(root);
+             iter != floating_entries.end()) {
+    root_entry = iter->second;
+  }
+  // Not indexed, so hidden or outside the bounds
+  if (root_entry == -1) {
+    return ElementPtr();
+  }
+
+  std::size_t cell = cell_index(position);
+  auto begin = cell_entries.begin() + cell_begin[cell];
+  auto end = cell_entries.begin() + cell_begin[cell + 1];
+  auto iter = std::lower_bound(begin, end, root_entry);
+  if (iter == end || *iter != root_entry ||
+      !entries[root_entry].contains(position)) {
+    return ElementPtr();
+  }
+
+  // Entries in the cell are in pre-order, so the first child containing the
+  // position is found before its siblings, and the search continues within
+  // its subtree
+  int current = root_entry;
+  for (iter++; iter != end && *iter < entries[root_entry].end; iter++) {
+    const auto& entry = entries[*iter];
+    if (entry.parent == current && entry.contains(position)) {
+      current = *iter;
+    }
+  }
+  return entries[current].element;
+}
+
+std::size_t HitGrid::cell_index(const Vec2& position) const {
+  std::size_t x = (position.x - bounds.lower.x) / cell_size;
+  std::size_t y = (position.y - bounds.lower.y) / cell_size;
+  return std::min(y, cells_y - 1) * cells_x + std::min(x, cells_x - 1);
+}
+
+} // namespace dgui
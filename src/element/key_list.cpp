@@ -1,7 +1,173 @@
 #include "datagui/element/key_list.hpp"
+#include <assert.h>
 
 namespace dgui {
 
-std::size_t KeyList::next_key = 0;
+std::atomic_size_t KeyList::next_key = 1;
+
+std::size_t KeyList::insert(std::size_t pos) {
+  if (pos > size()) {
+    throw std::out_of_range("Insert position is past the end");
+  }
+  std::size_t key = next_key.fetch_add(1, std::memory_order_relaxed);
+  int node = nodes.emplace(key, next_priority());
+  nodes_by_key.emplace(key, node);
+
+  auto [lhs, rhs] = split(root, pos);
+  root = merge(merge(lhs, node), rhs);
+  nodes[root].parent = -1;
+  return key;
+}
+
+void KeyList::remove(std::size_t key) {
+  auto iter = nodes_by_key.find(key);
+  if (iter == nodes_by_key.end()) {
+    throw std::runtime_error("Key doesn't exist, cannot remove");
+  }
+  int node = iter->second;
+  nodes_by_key.erase(iter);
+
+  // Replace the node with its children merged
+  int parent = nodes[node].parent;
+  int replacement = merge(nodes[node].left, nodes[node].right);
+  if (replacement != -1) {
+    nodes[replacement].parent = parent;
+  }
+  if (parent == -1) {
+    root = replacement;
+  } else if (nodes[parent].left == node) {
+    nodes[parent].left = replacement;
+  } else {
+    nodes[parent].right = replacement;
+  }
+  nodes.pop(node);
+
+  while (parent != -1) {
+    nodes[parent].size--;
+    parent = nodes[parent].parent;
+  }
+}
+
+std::size_t KeyList::operator[](std::size_t i) const {
+  assert(i < size());
+  int node = root;
+  while (true) {
+    std::size_t left_size = subtree_size(nodes[node].left);
+    if (i < left_size) {
+      node = nodes[node].left;
+    } else if (i == left_size) {
+      return nodes[node].key;
+    } else {
+      i -= left_size + 1;
+      node = nodes[node].right;
+    }
+  }
+}
+
+std::size_t KeyList::index(std::size_t key) const {
+  auto iter = nodes_by_key.find(key);
+  if (iter == nodes_by_key.end()) {
+    throw std::runtime_error("Key doesn't exist");
+  }
+  int node = iter->second;
+  std::size_t result = subtree_size(nodes[node].left);
+  while (nodes[node].parent != -1) {
+    int parent = nodes[node].parent;
+    if (nodes[parent].right == node) {
+      result += subtree_size(nodes[parent].left) + 1;
+    }
+    node = parent;
+  }
+  return result;
+}
+
+KeyList::ConstIterator& KeyList::ConstIterator::operator++() {
+  assert(node != -1);
+  const auto& nodes = list->nodes;
+  if (nodes[node].right != -1) {
+    node = nodes[node].right;
+    while (nodes[node].left != -1) {
+      node = nodes[node].left;
+    }
+    return *this;
+  }
+  // Go up until coming from a left child
+  int prev = node;
+  node = nodes[node].parent;
+  while (node != -1 && nodes[node].right == prev) {
+    prev = node;
+    node = nodes[node].parent;
+  }
+  return *this;
+}
+
+KeyList::ConstIterator KeyList::begin() const {
+  int node = root;
+  while (node != -1 && nodes[node].left != -1) {
+    node = nodes[node].left;
+  }
+  return ConstIterator(this, node);
+}
+
+void KeyList::update(int node) {
+  auto& n = nodes[node];
+  n.size = 1 + subtree_size(n.left) + subtree_size(n.right);
+  if (n.left != -1) {
+    nodes[n.left].parent = node;
+  }
+  if (n.right != -1) {
+    nodes[n.right].parent = node;
+  }
+}
+
+int KeyList::merge(int lhs, int rhs) {
+  if (lhs == -1) {
+    return rhs;
+  }
+  if (rhs == -1) {
+    return lhs;
+  }
+  if (nodes[lhs].priority > nodes[rhs].priority) {
+    nodes[lhs].right = merge(nodes[lhs].right, rhs);
+    update(lhs);
+    return lhs;
+  } else {
+    nodes[rhs].left = merge(lhs, nodes[rhs].left);
+    update(rhs);
+    return rhs;
+  }
+}
+
+std::pair<int, int> KeyList::split(int node, std::size_t count) {
+  if (node == -1) {
+    return {-1, -1};
+  }
+  std::size_t left_size = subtree_size(nodes[node].left);
+  if (count <= left_size) {
+    auto [lhs, rhs] = split(nodes[node].left, count);
+    nodes[node].left = rhs;
+    update(node);
+    if (lhs != -1) {
+      nodes[lhs].parent = -1;
+    }
+    return {lhs, node};
+  } else {
+    auto [lhs, rhs] = split(nodes[node].right, count - left_size - 1);
+    nodes[node].right = lhs;
+    update(node);
+    if (rhs != -1) {
+      nodes[rhs].parent = -1;
+    }
+    return {node, rhs};
+  }
+}
+
+std::uint32_t KeyList::next_priority() {
+  // xorshift32
+  random_state ^= random_state << 13;
+  random_state ^= random_state >> 17;
+  random_state ^= random_state << 5;
+  return random_state;
+}
 
 } // namespace dgui
@@ -6,6 +6,12 @@ namespace dgui {
 
 int Tree::create_element(int parent, int prev, std::size_t id, Type type) {
   int element = elements.emplace();
+  modified_ = true;
+  if (cold_states.size() < elements.slots()) {
+    cold_states.resize(elements.slots());
+  } else {
+    cold_states[element] = ColdState();
+  }
   auto& node = elements[element];
   node.parent = parent;
   node.id = id;
@@ -36,21 +42,117 @@ int Tree::create_element(int parent, int prev, std::size_t id, Type type) {
   } else if (parent != -1) {
     elements[parent].last_child = element;
   }
+
+  insert_key(element);
+  set_dirty(element);
   return element;
 }
 
+void Tree::move_element(int element, int next) {
+  auto& node = elements[element];
+  assert(node.parent != -1);
+  assert(next == -1 || elements[next].parent == node.parent);
+  if (node.next == next) {
+    return;
+  }
+  modified_ = true;
+  auto& parent = elements[node.parent];
+
+  // Unlink
+  if (node.prev != -1) {
+    elements[node.prev].next = node.next;
+  } else {
+    parent.first_child = node.next;
+  }
+  if (node.next != -1) {
+    elements[node.next].prev = node.prev;
+  } else {
+    parent.last_child = node.prev;
+  }
+
+  // Relink before next
+  node.next = next;
+  node.prev = next == -1 ? parent.last_child : elements[next].prev;
+  if (node.prev != -1) {
+    elements[node.prev].next = element;
+  } else {
+    parent.first_child = element;
+  }
+  if (next != -1) {
+    elements[next].prev = element;
+  } else {
+    parent.last_child = element;
+  }
+  set_dirty(node.parent);
+}
+
+void Tree::set_dirty(int element) {
+  elements[element].state.dirty = true;
+  modified_ = true;
+  set_render_dirty(element);
+  // Ancestors of a dirty element are already dirty, unless it was hidden
+  // when last laid out
+  int iter = elements[element].parent;
+  while (iter != -1 && !elements[iter].state.dirty) {
+    elements[iter].state.dirty = true;
+    iter = elements[iter].parent;
+  }
+}
+
+void Tree::set_render_dirty(int element) {
+  cold_states[element].render_dirty = true;
+  cold_states[element].subtree_render_dirty = true;
+  // Ancestors of an element with subtree_render_dirty set have it set too,
+  // since it is only cleared over whole subtrees
+  int iter = elements[element].parent;
+  while (iter != -1 && !cold_states[iter].subtree_render_dirty) {
+    cold_states[iter].subtree_render_dirty = true;
+    iter = elements[iter].parent;
+  }
+}
+
+void Tree::insert_key(int element) {
+  const auto& node = elements[element];
+  if (node.id == 0 || node.parent == -1) {
+    return;
+  }
+  // If the id is already used by a sibling, keep the existing entry
+  keyed_elements.emplace(ElementKey{node.parent, node.id}, element);
+}
+
+void Tree::erase_key(int element) {
+  const auto& node = elements[element];
+  if (node.id == 0 || node.parent == -1) {
+    return;
+  }
+  auto iter = keyed_elements.find(ElementKey{node.parent, node.id});
+  if (iter != keyed_elements.end() && iter->second == element) {
+    keyed_elements.erase(iter);
+  }
+}
+
 void Tree::reset_element(int element, std::size_t id, Type type) {
   auto& node = elements[element];
+  modified_ = true;
+  erase_key(element);
   node.id = id;
+  insert_key(element);
   pop_type(node.type, node.type_index);
   node.type = type;
   node.type_index = emplace_type(type);
 
   // Clear children
   remove_element(element, true);
+  set_dirty(element);
 }
 
 void Tree::remove_element(int root, bool children_only) {
+  if (!children_only && elements[root].parent != -1) {
+    set_dirty(elements[root].parent);
+  } else if (children_only && elements[root].first_child != -1) {
+    set_dirty(root);
+  }
+
   std::stack<int> stack;
   stack.push(root);
 
@@ -64,7 +166,7 @@ void Tree::remove_element(int root, bool children_only) {
         return;
       }
 
-      removed_elements.push_back(element);
+      modified_ = true;
 
       if (node.prev != -1) {
         elements[node.prev].next = node.next;
@@ -78,6 +180,7 @@ void Tree::remove_element(int root, bool children_only) {
       }
 
       clear_variables(element);
+      erase_key(element);
 
       pop_type(elements[element].type, elements[element].type_index);
       elements.pop(element);
@@ -104,6 +207,7 @@ int Tree::emplace_type(Type type) {
     HANDLE(ColorPicker, color_picker);
     HANDLE(Dropdown, dropdown);
     HANDLE(Group, group);
+    HANDLE(Memo, memo);
     HANDLE(Popup, popup);
     HANDLE(Select, select);
     HANDLE(Slider, slider);
@@ -112,6 +216,7 @@ int Tree::emplace_type(Type type) {
     HANDLE(TextBox, text_box);
     HANDLE(TextInput, text_input);
     HANDLE(ViewportPtr, viewport);
+    HANDLE(VirtualList, virtual_list);
   default:
     assert(false);
     return -1;
@@ -133,6 +238,7 @@ void Tree::pop_type(Type type, std::size_t index) {
     HANDLE(ColorPicker, color_picker);
     HANDLE(Dropdown, dropdown);
     HANDLE(Group, group);
+    HANDLE(Memo, memo);
     HANDLE(Popup, popup);
     HANDLE(Select, select);
     HANDLE(Slider, slider);
@@ -141,6 +247,7 @@ void Tree::pop_type(Type type, std::size_t index) {
     HANDLE(TextBox, text_box);
     HANDLE(TextInput, text_input);
     HANDLE(ViewportPtr, viewport);
+    HANDLE(VirtualList, virtual_list);
   default:
     assert(false);
     break;
@@ -149,6 +256,122 @@ void Tree::pop_type(Type type, std::size_t index) {
 #undef HANDLE
 }
 
+template <typename T>
+static bool should_compact(
+    const VectorMap<T>& map,
+    float min_occupancy,
+    std::size_t min_slots) {
+  return map.slots() >= min_slots &&
+         map.size() < min_occupancy * map.slots();
+}
+
+bool Tree::compact(float min_occupancy, std::size_t min_slots) {
+  auto remap_index = [](const std::vector<int>& remap, int& index) {
+    if (index != -1) {
+      index = remap[index];
+    }
+  };
+
+  // Props, referenced by ElementNode::type_index
+#define HANDLE(Name, name) \
+  if (should_compact(name, min_occupancy, min_slots)) { \
+    auto remap = name.compact(); \
+    for (auto& node : elements) { \
+      if (node.type == Type::Name) { \
+        node.type_index = remap[node.type_index]; \
+      } \
+    } \
+  }
+
+  HANDLE(Button, button);
+  HANDLE(Checkbox, checkbox);
+  HANDLE(Collapsable, collapsable);
+  HANDLE(ColorPicker, color_picker);
+  HANDLE(Dropdown, dropdown);
+  HANDLE(Group, group);
+  HANDLE(Memo, memo);
+  HANDLE(Popup, popup);
+  HANDLE(Select, select);
+  HANDLE(Slider, slider);
+  HANDLE(Split, split);
+  HANDLE(Tabs, tabs);
+  HANDLE(TextBox, text_box);
+  HANDLE(TextInput, text_input);
+  HANDLE(ViewportPtr, viewport);
+  HANDLE(VirtualList, virtual_list);
+
+#undef HANDLE
+
+  if (should_compact(variables, min_occupancy, min_slots)) {
+    auto remap = variables.compact();
+    for (auto& node : elements) {
+      remap_index(remap, node.first_variable);
+    }
+    for (auto& var : variables) {
+      remap_index(remap, var.prev);
+      remap_index(remap, var.next);
+    }
+    remap_index(remap, external_var_);
+  }
+
+  element_remap.clear();
+  if (!should_compact(elements, min_occupancy, min_slots)) {
+    return false;
+  }
+  element_remap = elements.compact();
+  std::vector<ColdState> new_cold_states(elements.size());
+  for (std::size_t i = 0; i < element_remap.size(); i++) {
+    if (element_remap[i] != -1) {
+      new_cold_states[element_remap[i]] = std::move(cold_states[i]);
+    }
+  }
+  cold_states = std::move(new_cold_states);
+  for (auto& node : elements) {
+    remap_index(element_remap, node.parent);
+    remap_index(element_remap, node.prev);
+    remap_index(element_remap, node.next);
+    remap_index(element_remap, node.first_child);
+    remap_index(element_remap, node.last_child);
+  }
+  for (auto& var : variables) {
+    remap_index(element_remap, var.element);
+  }
+  remap_index(element_remap, root_);
+
+  keyed_elements.clear();
+  for (std::size_t i = 0; i < elements.size(); i++) {
+    insert_key(i);
+  }
+  return true;
+}
+
+void Tree::remap(ElementPtr& element) {
+  if (element.tree != this || element_remap.empty()) {
+    return;
+  }
+  auto remap_index = [this](int index) {
+    if (index < 0 || std::size_t(index) >= element_remap.size()) {
+      return -1;
+    }
+    return element_remap[index];
+  };
+
+  int index = remap_index(element.index);
+  // Compaction increments every generation, so the handle was valid if
+  // it is one behind
+  if (index != -1 &&
+      elements.generation(element.index) != element.generation + 1) {
+    index = -1;
+  }
+  int parent = remap_index(element.parent_);
+
+  if (index == -1 && element.index != -1) {
+    element = ElementPtr();
+    return;
+  }
+  element = ElementPtr(this, parent, index);
+}
+
 int Tree::create_variable(int element) {
   int variable = variables.emplace(element);
 
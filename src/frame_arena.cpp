@@ -0,0 +1,59 @@
+#include "datagui/frame_arena.hpp"
+#include <assert.h>
+#include <cstdint>
+
+namespace dgui {
+
+FrameArena::FrameArena(std::size_t initial_capacity) :
+    buffer(new std::byte[initial_capacity]), capacity_(initial_capacity) {}
+
+void FrameArena::reset() {
+  if (!overflow.empty()) {
+    std::size_t required = used + overflow_bytes;
+    std::size_t new_capacity = capacity_;
+    while (new_capacity < required) {
+      new_capacity *= 2;
+    }
+    buffer.reset(new std::byte[new_capacity]);
+    capacity_ = new_capacity;
+    overflow.clear();
+    overflow_bytes = 0;
+  }
+  used = 0;
+  allocations_ = 0;
+  heap_allocations_ = 0;
+}
+
+static std::size_t align_offset(std::uintptr_t address, std::size_t alignment) {
+  assert((alignment & (alignment - 1)) == 0);
+  return (alignment - (address & (alignment - 1))) & (alignment - 1);
+}
+
+void* FrameArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+  allocations_.fetch_add(1, std::memory_order_relaxed);
+
+  std::uintptr_t start = std::uintptr_t(buffer.get());
+  std::size_t offset = used.load(std::memory_order_relaxed);
+  while (true) {
+    std::size_t padding = align_offset(start + offset, alignment);
+    if (offset + padding + bytes > capacity_) {
+      break;
+    }
+    if (used.compare_exchange_weak(
+            offset,
+            offset + padding + bytes,
+            std::memory_order_relaxed)) {
+      return reinterpret_cast<void*>(start + offset + padding);
+    }
+  }
+
+  heap_allocations_.fetch_add(1, std::memory_order_relaxed);
+  std::size_t block_size = bytes + alignment;
+  std::lock_guard<std::mutex> lock(overflow_mutex);
+  auto& block = overflow.emplace_back(new std::byte[block_size]);
+  overflow_bytes += block_size;
+  std::uintptr_t address = std::uintptr_t(block.get());
+  return reinterpret_cast<void*>(address + align_offset(address, alignment));
+}
+
+} // namespace dgui
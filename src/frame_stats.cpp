@@ -0,0 +1,66 @@
+#include "datagui/frame_stats.hpp"
+#include <algorithm>
+#include <assert.h>
+
+namespace dgui {
+
+FrameStats::FrameStats(std::size_t window_size) : window_size(window_size) {
+  assert(window_size > 0);
+  for (auto& phase_samples : samples) {
+    phase_samples.values.reserve(window_size);
+  }
+}
+
+PhaseTiming FrameStats::timing(FramePhase phase) const {
+  const auto& phase_samples = samples[static_cast<std::size_t>(phase)];
+  PhaseTiming result;
+  result.samples = phase_samples.values.size();
+  if (result.samples == 0) {
+    return result;
+  }
+  result.last = phase_samples.last;
+
+  // Only sort on request, so recording stays cheap
+  std::vector<double> sorted = phase_samples.values;
+  std::sort(sorted.begin(), sorted.end());
+  result.min = sorted.front();
+  for (double value : sorted) {
+    result.mean += value;
+  }
+  result.mean /= sorted.size();
+  std::size_t p99_index = (sorted.size() * 99) / 100;
+  result.p99 = sorted[std::min(p99_index, sorted.size() - 1)];
+  return result;
+}
+
+void FrameStats::frame_begin() {
+  if (frame_ended_) {
+    record(
+        FramePhase::Build,
+        std::chrono::duration<double>(clock_t::now() - frame_end_).count());
+  }
+  // Keep the capacity of layer_times across frames
+  auto layer_times = std::move(counters_.layer_times);
+  counters_ = FrameCounters{};
+  layer_times.clear();
+  counters_.layer_times = std::move(layer_times);
+}
+
+void FrameStats::frame_end() {
+  frame_count_++;
+  frame_end_ = clock_t::now();
+  frame_ended_ = true;
+}
+
+void FrameStats::record(FramePhase phase, double seconds) {
+  auto& phase_samples = samples[static_cast<std::size_t>(phase)];
+  if (phase_samples.values.size() < window_size) {
+    phase_samples.values.push_back(seconds);
+  } else {
+    phase_samples.values[phase_samples.next] = seconds;
+    phase_samples.next = (phase_samples.next + 1) % window_size;
+  }
+  phase_samples.last = seconds;
+}
+
+} // namespace dgui
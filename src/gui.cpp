@@ -1,4 +1,6 @@
 #include "datagui/gui.hpp"
+#include <chrono>
+#include <cmath>
 #include <sstream>
 #include <stack>
 
@@ -8,6 +10,7 @@
 #include "datagui/system/color_picker.hpp"
 #include "datagui/system/dropdown.hpp"
 #include "datagui/system/group.hpp"
+#include "datagui/system/memo.hpp"
 #include "datagui/system/popup.hpp"
 #include "datagui/system/select.hpp"
 #include "datagui/system/slider.hpp"
@@ -16,6 +19,7 @@
 #include "datagui/system/text_box.hpp"
 #include "datagui/system/text_input.hpp"
 #include "datagui/system/viewport_ptr.hpp"
+#include "datagui/system/virtual_list.hpp"
 
 namespace dgui {
 
@@ -30,12 +34,15 @@ Gui::~Gui() {
 void Gui::open(
     const std::string& title,
     std::size_t width,
-    std::size_t height) {
-  window.open(title, width, height);
+    std::size_t height,
+    WindowMode mode) {
+  window_.open(title, width, height, mode);
 
   fm = std::make_shared<FontManager>();
   theme = std::make_shared<Theme>(theme_default());
-  renderer.init(fm);
+  arena = std::make_shared<FrameArena>();
+  renderer.init(fm, arena);
+  cache_renderer.init(fm, arena);
 
   systems.resize(TypeCount);
 
@@ -44,11 +51,12 @@ void Gui::open(
 
   REGISTER(Button, ButtonSystem, fm, theme);
   REGISTER(Checkbox, CheckboxSystem, fm, theme);
-  REGISTER(Collapsable, CollapsableSystem, fm, theme);
+  REGISTER(Collapsable, CollapsableSystem, fm, theme, arena);
   REGISTER(ColorPicker, ColorPickerSystem, fm, theme);
-  REGISTER(Dropdown, DropdownSystem, fm, theme);
-  REGISTER(Group, GroupSystem, theme);
-  REGISTER(Popup, PopupSystem, fm, theme);
+  REGISTER(Dropdown, DropdownSystem, fm, theme, arena);
+  REGISTER(Group, GroupSystem, theme, arena);
+  REGISTER(Memo, MemoSystem, theme, arena);
+  REGISTER(Popup, PopupSystem, fm, theme, arena);
   REGISTER(Select, SelectSystem, fm, theme);
   REGISTER(Slider, SliderSystem, fm, theme);
   REGISTER(Split, SplitSystem, theme);
@@ -56,6 +64,7 @@ void Gui::open(
   REGISTER(TextBox, TextBoxSystem, fm, theme);
   REGISTER(TextInput, TextInputSystem, fm, theme);
   REGISTER(ViewportPtr, ViewportPtrSystem);
+  REGISTER(VirtualList, VirtualListSystem, theme);
 
 #undef REGISTER
   for (const auto& system : systems) {
@@ -64,7 +73,54 @@ void Gui::open(
 }
 
 void Gui::close() {
-  window.close();
+  // Needs the window's context
+  render_caches.clear();
+  render_caches_by_element.clear();
+  render_cache_memory = 0;
+  window_.close();
+}
+
+void Gui::idle_mode(bool enabled, double timeout) {
+  idle_mode_ = enabled;
+  idle_timeout_ = timeout;
+}
+
+void Gui::parallel_layout(std::size_t threads, std::size_t min_elements) {
+  if (threads <= 1) {
+    layout_pool.reset();
+  } else if (!layout_pool || layout_pool->threads() != threads) {
+    layout_pool = std::make_unique<ThreadPool>(threads);
+  }
+  parallel_layout_min_elements = min_elements;
+}
+
+void Gui::render_cache_limit(std::size_t bytes) {
+  render_cache_limit_ = bytes;
+}
+
+void Gui::request_redraw() {
+  redraw_ = true;
+  if (idle_mode_) {
+    window_.wake();
+  }
+}
+
+void Gui::start_recording() {
+  recording.clear();
+  recording_ = true;
+}
+
+InputRecording Gui::stop_recording() {
+  recording_ = false;
+  return std::move(recording);
+}
+
+void Gui::start_replay(InputRecording input) {
+  replay = std::move(input);
+  replay_frame = 0;
+  replay_index = 0;
+  replaying_ = true;
+  window_.set_vsync(false);
 }
 
 void Gui::move_down() {
@@ -85,17 +141,80 @@ void Gui::end() {
 }
 
 bool Gui::poll() {
-  if (element_focus && tree.has_removed(element_focus)) {
-    element_focus = ElementPtr();
-  }
-  tree.clear_removed();
+  frame_stats_.frame_begin();
+  arena->reset();
 
   assert(stack.empty());
-  calculate_sizes();
-  render();
-  event_handling();
 
-  if (!window.running()) {
+  // Keep the stores dense as elements are created and removed over time
+  if (tree.compact()) {
+    hit_grid.invalidate();
+    tree.remap(element_focus);
+    tree.remap(element_hover);
+    tree.remap(element_left_held);
+    tree.remap(element_middle_held);
+
+    auto prev_floating_elements = std::move(floating_elements);
+    floating_elements.clear();
+    ordered_floating_elements.clear();
+    for (auto element : prev_floating_elements) {
+      tree.remap(element);
+      if (element) {
+        floating_elements.insert(element);
+        ordered_floating_elements.insert(element);
+      }
+    }
+
+    render_caches_by_element.clear();
+    for (auto iter = render_caches.begin(); iter != render_caches.end();) {
+      tree.remap(iter->element);
+      if (iter->element) {
+        render_caches_by_element.emplace(iter->element, iter);
+        iter++;
+      } else {
+        render_cache_memory -= iter->layer->memory();
+        iter = render_caches.erase(iter);
+      }
+    }
+  }
+
+  // Skip layout and rendering if nothing has changed since the last frame.
+  // Any element marked dirty while building the previous frame, by any
+  // system or writer, leaves the tree modified. Consumes the redraw request,
+  // so changes made while building the next frame request a new one.
+  bool redraw = redraw_.exchange(false) || tree.modified() || !idle_mode_;
+  tree.clear_modified();
+  if (redraw) {
+    auto timer = frame_stats_.start(FramePhase::Layout);
+    calculate_sizes();
+    timer.stop();
+    render();
+  }
+
+  // After a redraw, don't block, so any response by the caller to the
+  // changes is picked up on the next frame
+  event_handling(idle_mode_ && !redraw);
+  if (window_.has_input()) {
+    redraw_ = true;
+  }
+
+  auto& counters = frame_stats_.counters();
+  counters.redrawn = redraw;
+  counters.cache_memory = render_cache_memory;
+  counters.arena_allocations = arena->allocations();
+  counters.arena_heap_allocations = arena->heap_allocations();
+  auto text_cache_stats = fm->text_cache_stats();
+  counters.text_cache_hits = text_cache_stats.hits;
+  counters.text_cache_misses = text_cache_stats.misses;
+  fm->reset_text_cache_stats();
+  frame_stats_.frame_end();
+
+  if (!window_.running()) {
+    return false;
+  }
+  if (replaying_ && replay_frame >= replay.frame_count()) {
+    replaying_ = false;
+    window_.set_vsync(true);
     return false;
   }
 
@@ -114,11 +233,7 @@ bool Gui::button(const std::string& text) {
   args_.apply(current);
   current = current.next();
 
-  if (button.released) {
-    button.released = false;
-    return true;
-  }
-  return false;
+  return consume(button.released);
 }
 
 std::optional<bool> Gui::checkbox(bool initial_value) {
@@ -130,8 +245,7 @@ std::optional<bool> Gui::checkbox(bool initial_value) {
   args_.apply(current);
   current = current.next();
 
-  if (checkbox.changed) {
-    checkbox.changed = false;
+  if (consume(checkbox.changed)) {
     return checkbox.checked;
   }
   return std::nullopt;
@@ -139,16 +253,16 @@ std::optional<bool> Gui::checkbox(bool initial_value) {
 
 bool Gui::checkbox_v(bool& value) {
   current.expect(Type::Checkbox, read_key());
+  auto element = current;
   auto& checkbox = current.checkbox();
   args_.apply(current);
   current = current.next();
 
-  if (checkbox.changed) {
-    checkbox.changed = false;
+  if (consume(checkbox.changed)) {
     value = checkbox.checked;
     return true;
   } else {
-    checkbox.checked = value;
+    update(element, checkbox.checked, value);
     return false;
   }
 }
@@ -157,7 +271,7 @@ bool Gui::collapsable(const std::string& label) {
   current.expect(Type::Collapsable, read_key());
   args_.apply(current);
   auto& collapsable = current.collapsable();
-  collapsable.label = label;
+  update(current, collapsable.label, label);
 
   if (collapsable.open) {
     move_down();
@@ -176,8 +290,7 @@ std::optional<Color> Gui::color_picker(const Color& initial_value) {
   args_.apply(current);
   current = current.next();
 
-  if (color_picker.changed) {
-    color_picker.changed = false;
+  if (consume(color_picker.changed)) {
     return color_picker.value;
   }
   return std::nullopt;
@@ -185,16 +298,19 @@ std::optional<Color> Gui::color_picker(const Color& initial_value) {
 
 bool Gui::color_picker_v(Color& value) {
   current.expect(Type::ColorPicker, read_key());
+  auto element = current;
   auto& color_picker = current.color_picker();
   args_.apply(current);
   current = current.next();
 
-  if (color_picker.changed) {
-    color_picker.changed = false;
+  if (consume(color_picker.changed)) {
     value = color_picker.value;
     return true;
   } else {
-    color_picker.value = value;
+    if (!color_picker.value.equals(value)) {
+      color_picker.value = value;
+      element.set_dirty();
+    }
     return false;
   }
 }
@@ -204,7 +320,7 @@ bool Gui::dropdown(const std::string& label) {
   args_.apply(current);
   auto& dropdown = current.dropdown();
 
-  dropdown.label = label;
+  update(current, dropdown.label, label);
 
   if (!dropdown.open) {
     if (!dropdown.retain) {
@@ -224,6 +340,33 @@ void Gui::group() {
   move_down();
 }
 
+bool Gui::memo_hash(std::size_t deps_hash) {
+  bool is_new = current.expect(Type::Memo, read_key());
+  args_.tight();
+  args_.apply(current);
+  auto& memo = current.memo();
+
+  if (!is_new && !memo.dirty && memo.deps_hash == deps_hash) {
+    current = current.next();
+    return false;
+  }
+  memo.deps_hash = deps_hash;
+  memo.dirty = false;
+  move_down();
+  return true;
+}
+
+void Gui::input_received(ElementPtr element) {
+  element.set_dirty();
+  // The input may change what can be hit, eg: Closing a dropdown
+  hit_grid.invalidate();
+  for (auto iter = element; iter; iter = iter.parent()) {
+    if (iter.type() == Type::Memo) {
+      iter.memo().dirty = true;
+    }
+  }
+}
+
 bool Gui::popup(
     bool& open,
     const std::string& title,
@@ -233,15 +376,15 @@ bool Gui::popup(
   args_.apply(current);
   auto& popup = current.popup();
 
-  popup.title = title;
-  popup.popup_size = Vec2(width, height);
+  update(current, popup.title, title);
+  update(current, popup.popup_size, Vec2(width, height));
 
-  if (popup.close_button_released) {
-    popup.close_button_released = false;
+  if (consume(popup.close_button_released)) {
     open = false;
     popup.open = false;
+    current.set_dirty();
   } else {
-    popup.open = open;
+    update(current, popup.open, open);
   }
   if (popup.open) {
     move_down();
@@ -262,16 +405,15 @@ std::optional<int> Gui::select(
   if (is_new) {
     select.choice = initial_choice;
   }
-  select.choices = choices;
+  update(current, select.choices, choices);
   if (select.choice >= 0 &&
       static_cast<size_t>(select.choice) >= choices.size()) {
-    select.choice = std::max(1ul, choices.size()) - 1;
+    update(current, select.choice, int(std::max(1ul, choices.size()) - 1));
   }
   args_.apply(current);
   current = current.next();
 
-  if (select.changed) {
-    select.changed = false;
+  if (consume(select.changed)) {
     return select.choice;
   }
   return std::nullopt;
@@ -279,16 +421,16 @@ std::optional<int> Gui::select(
 
 bool Gui::select_v(int& choice, const std::vector<std::string>& choices) {
   current.expect(Type::Select, read_key());
+  auto element = current;
   auto& select = current.select();
   args_.apply(current);
   current = current.next();
 
-  if (select.changed) {
-    select.changed = false;
+  if (consume(select.changed)) {
     choice = select.choice;
     return true;
   } else {
-    select.choice = choice;
+    update(element, select.choice, choice);
     return false;
   }
 }
@@ -296,10 +438,11 @@ bool Gui::select_v(int& choice, const std::vector<std::string>& choices) {
 template <typename T>
 std::optional<T> Gui::slider(T initial_value, T lower, T upper) {
   bool is_new = current.expect(Type::Slider, read_key());
+  auto element = current;
   auto& slider = current.slider();
   slider.type = number_type<T>();
-  slider.lower = static_cast<T>(lower);
-  slider.upper = static_cast<T>(upper);
+  update(element, slider.lower, static_cast<double>(lower));
+  update(element, slider.upper, static_cast<double>(upper));
   if (is_new) {
     slider.value = std::clamp(
         static_cast<double>(initial_value),
@@ -313,10 +456,10 @@ std::optional<T> Gui::slider(T initial_value, T lower, T upper) {
   if (slider.value < slider.lower || slider.value > slider.upper) {
     slider.value = std::clamp(slider.value, slider.lower, slider.upper);
     slider.changed = true;
+    element.set_dirty();
   }
 
-  if (slider.changed) {
-    slider.changed = false;
+  if (consume(slider.changed)) {
     return static_cast<T>(slider.value);
   }
   return std::nullopt;
@@ -325,20 +468,22 @@ std::optional<T> Gui::slider(T initial_value, T lower, T upper) {
 template <typename T>
 bool Gui::slider_v(T& value, T lower, T upper) {
   current.expect(Type::Slider, read_key());
+  auto element = current;
   auto& slider = current.slider();
   slider.type = number_type<T>();
-  slider.lower = static_cast<T>(lower);
-  slider.upper = static_cast<T>(upper);
+  update(element, slider.lower, static_cast<double>(lower));
+  update(element, slider.upper, static_cast<double>(upper));
   args_.apply(current);
 
   current = current.next();
 
-  if (!slider.changed) {
-    slider.value = static_cast<double>(value);
+  if (!consume(slider.changed)) {
+    update(element, slider.value, static_cast<double>(value));
     if (slider.value >= slider.lower && slider.value <= slider.upper) {
       return false;
     }
     slider.value = std::clamp(slider.value, slider.lower, slider.upper);
+    element.set_dirty();
   }
   // Changed or clamped
 
@@ -366,7 +511,7 @@ void Gui::hsplit(float ratio) {
   if (is_new) {
     split.ratio = ratio;
   }
-  split.direction = Direction::Horizontal;
+  update(current, split.direction, Direction::Horizontal);
 
   move_down();
 }
@@ -379,7 +524,7 @@ void Gui::vsplit(float ratio) {
   if (is_new) {
     split.ratio = ratio;
   }
-  split.direction = Direction::Vertical;
+  update(current, split.direction, Direction::Vertical);
 
   move_down();
 }
@@ -393,7 +538,11 @@ void Gui::tabs(size_t initial_tab) {
   }
   if (!is_new && tabs.tab >= tabs.labels.size()) {
     tabs.tab = std::max(1ul, tabs.labels.size()) - 1;
+    current.set_dirty();
   }
+  // Re-added by tab_group(), keeping the previous labels to check if they
+  // have changed
+  std::swap(tabs.labels, tabs.prev_labels);
   tabs.labels.clear();
   move_down();
 }
@@ -408,12 +557,15 @@ bool Gui::tab_group(const std::string& label) {
 
   size_t index = tabs.labels.size();
   tabs.labels.push_back(label);
+  if (index >= tabs.prev_labels.size() || tabs.prev_labels[index] != label) {
+    parent.set_dirty();
+  }
   if (tabs.tab == index) {
-    current.state().hidden = false;
+    update(current, current.state().hidden, false);
     move_down();
     return true;
   }
-  current.state().hidden = true;
+  update(current, current.state().hidden, true);
   current = current.next();
   return false;
 }
@@ -427,8 +579,7 @@ const std::string* Gui::text_input(const std::string& initial_value) {
   args_.apply(current);
   current = current.next();
 
-  if (text_input.changed) {
-    text_input.changed = false;
+  if (consume(text_input.changed)) {
     return &text_input.text;
   }
   return nullptr;
@@ -436,16 +587,16 @@ const std::string* Gui::text_input(const std::string& initial_value) {
 
 bool Gui::text_input_v(std::string& value) {
   current.expect(Type::TextInput, read_key());
+  auto element = current;
   auto& text_input = current.text_input();
   args_.apply(current);
   current = current.next();
 
-  if (text_input.changed) {
-    text_input.changed = false;
+  if (consume(text_input.changed)) {
     value = text_input.text;
     return true;
   } else {
-    text_input.text = value;
+    update(element, text_input.text, value);
     return false;
   }
 }
@@ -461,8 +612,7 @@ std::optional<T> Gui::number_input(T initial_value) {
   text_input.number_type = number_type<T>();
   current = current.next();
 
-  if (text_input.changed) {
-    text_input.changed = false;
+  if (consume(text_input.changed)) {
     T number;
     if (text_to_number(text_input.text, number)) {
       return number;
@@ -474,20 +624,20 @@ std::optional<T> Gui::number_input(T initial_value) {
 template <typename T>
 bool Gui::number_input_v(T& value) {
   current.expect(Type::TextInput, read_key());
+  auto element = current;
   auto& text_input = current.text_input();
   args_.apply(current);
   text_input.number_type = number_type<T>();
   current = current.next();
 
-  if (text_input.changed) {
-    text_input.changed = false;
+  if (consume(text_input.changed)) {
     T number;
     if (text_to_number(text_input.text, number)) {
       value = number;
       return true;
     }
   }
-  text_input.text = std::to_string(value);
+  update(element, text_input.text, std::to_string(value));
   return false;
 }
 
@@ -507,27 +657,70 @@ void Gui::text_box(const std::string& text) {
   current.expect(Type::TextBox, read_key());
   auto& text_box = current.text_box();
   args_.apply(current);
+  update(current, text_box.text, text);
   current = current.next();
+}
 
-  text_box.text = text;
+void Gui::virtual_list(
+    std::size_t count,
+    float row_height,
+    const std::function<void(std::size_t)>& row) {
+  current.expect(Type::VirtualList, read_key());
+  args_.apply(current);
+  auto& list = current.virtual_list();
+  update(current, list.count, count);
+  update(current, list.row_height, row_height);
+
+  // Rows in view, from the size and scroll position of the last layout
+  std::size_t first = 0;
+  std::size_t last = 0;
+  std::size_t capacity = 1;
+  if (row_height > 0) {
+    float top = list.layout_state.scroll_pos.y;
+    float height = list.content_box.size().y;
+    // The most rows that can be partially in view. Always creating this
+    // many rows means scrolling reuses elements, rather than creating and
+    // removing them as the number of partially visible rows changes.
+    capacity = std::size_t(std::ceil(height / row_height)) + 1;
+    first = std::min(std::size_t(top / row_height), count);
+    last = std::min(first + capacity, count);
+  }
+  update(current, list.first_row, first);
+
+  move_down();
+  for (std::size_t i = first; i < last; i++) {
+    current.expect(Type::Group, i % capacity + 1);
+    auto& group = current.group();
+    group.layout.rows = 1;
+    group.layout.cols = -1;
+    group.layout.y_alignment = YAlignment::Center;
+    group.width = LengthDynamic();
+    move_down();
+    row(i);
+    end();
+  }
+  end();
 }
 
 void Gui::render() {
-  auto render_tree = [this](ConstElementPtr root) {
+  auto render_timer = frame_stats_.start(FramePhase::Render);
+  auto& counters = frame_stats_.counters();
+
+  auto render_tree = [this, &counters](ElementPtr root) {
     if (!root) {
       return;
     }
     struct State {
-      ConstElementPtr element;
+      ElementPtr element;
       bool first_visit;
-      State(ConstElementPtr element) : element(element), first_visit(true) {}
+      State(ElementPtr element) : element(element), first_visit(true) {}
     };
-    std::stack<State> stack;
+    FrameStack<State> stack(arena.get());
     stack.emplace(root);
 
     while (!stack.empty()) {
       auto& state = stack.top();
-      const auto& element = state.element;
+      auto element = state.element;
       assert(element);
 
       if (element.state().hidden ||
@@ -543,34 +736,258 @@ void Gui::render() {
       }
       state.first_visit = false;
 
-      render(element);
-      renderer.push_mask(element.state().child_mask);
+      // Cached groups draw their texture in place of their contents, if
+      // they fit in the cache
+      bool cached = element.type() == Type::Group && element.group().cached;
+      RenderCache* cache = cached ? render_cached(element) : nullptr;
+      // What it drew on the previous frame may not be valid any more
+      bool cache_changed =
+          cached && (!cache || cache->rendered_frame == renderer.frame());
+
+      // Replay what the element drew on the previous frame if nothing it
+      // draws has changed
+      auto& cold_state = element.cold_state();
+      const Box2& parent_mask = renderer.mask();
+      std::size_t begin = renderer.recorded();
+      if (!cold_state.render_dirty && !cache_changed &&
+          cold_state.render_mask.lower == parent_mask.lower &&
+          cold_state.render_mask.upper == parent_mask.upper &&
+          renderer.replay(
+              cold_state.render_frame,
+              cold_state.render_begin,
+              cold_state.render_end)) {
+        counters.elements_reused++;
+      } else {
+        if (cache) {
+          renderer.queue_cached(cache->box, cache->layer->texture());
+        } else {
+          render(element);
+        }
+        cold_state.render_dirty = false;
+        cold_state.render_mask = parent_mask;
+        // Often drawn the same, eg. when only a descendant changed, so
+        // doesn't need drawing again, unless the texture it draws changed
+        if (!(cache && cache_changed)) {
+          renderer.replay_if_same(
+              cold_state.render_frame,
+              cold_state.render_begin,
+              cold_state.render_end,
+              begin);
+        }
+      }
+      cold_state.render_frame = renderer.frame();
+      cold_state.render_begin = begin;
+      cold_state.render_end = renderer.recorded();
+      counters.elements_rendered++;
+
+      if (cache) {
+        counters.cached_groups++;
+        stack.pop();
+        continue;
+      }
+      renderer.push_mask(cold_state.child_mask);
 
+      const Box2& mask = renderer.mask();
       for (auto child = element.child(); child; child = child.next()) {
+        // Anything it draws would be masked out, and its children are masked
+        // to within its box
+        const auto& child_state = child.state();
+        if (!intersects(mask, child_state.box())) {
+          if (!child_state.hidden && !child_state.floating) {
+            counters.elements_culled++;
+          }
+          continue;
+        }
         stack.emplace(child);
       }
     }
   };
 
-  window.render_begin();
-  renderer.begin(Box2(Vec2(), window.size()));
+  double flush_time = 0;
+  auto flush = [this, &counters, &flush_time](std::size_t layer) {
+    auto start = std::chrono::steady_clock::now();
+    renderer.render(layer);
+    double elapsed = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    counters.layer_times.push_back(elapsed);
+    flush_time += elapsed;
+  };
+
+  // Keeps the previous frame, to only redraw the damaged region
+  window_.render_begin(false);
+  renderer.begin(Box2(Vec2(), window_.size()));
 
   render_tree(tree.root());
-  renderer.render();
+  renderer.end_layer();
 
   for (auto element : ordered_floating_elements) {
     render_tree(element);
-    renderer.render();
+    renderer.end_layer();
   }
 #ifdef DGUI_DEBUG
   if (debug_mode_) {
     debug_render();
-    renderer.render();
+    renderer.end_layer();
   }
 #endif
 
   renderer.end();
-  window.render_end();
+
+  const Box2& damage = renderer.damage();
+  window_.clear(damage);
+  for (std::size_t i = 0; i < renderer.layer_count(); i++) {
+    flush(i);
+  }
+  counters.damaged_fraction = damage.empty()
+                                  ? 0
+                                  : damage.area() / window_.viewport().area();
+
+  frame_stats_.record(FramePhase::Render, render_timer.elapsed() - flush_time);
+  frame_stats_.record(FramePhase::Flush, flush_time);
+
+  const auto& render_stats = renderer.stats();
+  counters.shape_instances =
+      renderer.primitives_drawn(GuiBatcher::Primitive::Shape);
+  counters.text_glyphs =
+      renderer.primitives_drawn(GuiBatcher::Primitive::Glyph);
+  counters.image_instances =
+      renderer.primitives_drawn(GuiBatcher::Primitive::Image);
+  counters.draw_calls += render_stats.draw_calls;
+  counters.bytes_uploaded += render_stats.bytes_uploaded;
+  counters.buffer_allocations += render_stats.buffer_allocations;
+  counters.layers_reused = renderer.layers_reused();
+  renderer.reset_stats();
+
+  auto swap_timer = frame_stats_.start(FramePhase::Swap);
+  window_.render_end();
+  swap_timer.stop();
+}
+
+Gui::RenderCache* Gui::render_cached(ElementPtr element) {
+  // Whole pixels, so the texture is drawn without resampling
+  Box2 box = element.state().box();
+  box.lower = Vec2(std::floor(box.lower.x), std::floor(box.lower.y));
+  box.upper = Vec2(std::ceil(box.upper.x), std::ceil(box.upper.y));
+  if (box.empty()) {
+    return nullptr;
+  }
+  std::size_t frame = renderer.frame();
+
+  auto iter = render_caches.end();
+  auto found = render_caches_by_element.find(element);
+  if (found != render_caches_by_element.end()) {
+    if (!(found->second->box.size() == box.size())) {
+      erase_render_cache(found->second);
+    } else {
+      iter = found->second;
+      render_caches.splice(render_caches.begin(), render_caches, iter);
+      if (iter->box.lower == box.lower &&
+          !element.cold_state().subtree_render_dirty) {
+        iter->used_frame = frame;
+        return &*iter;
+      }
+    }
+  }
+
+  if (iter == render_caches.end()) {
+    // Make room by evicting those drawn least recently, but not this frame
+    std::size_t memory =
+        std::size_t(box.area()) * CachedLayer::bytes_per_pixel;
+    if (memory > render_cache_limit_) {
+      return nullptr;
+    }
+    while (render_cache_memory + memory > render_cache_limit_) {
+      // Each is moved to the front when drawn, so if the last one was drawn
+      // this frame, all of them were
+      if (render_caches.back().used_frame == frame) {
+        return nullptr;
+      }
+      erase_render_cache(std::prev(render_caches.end()));
+    }
+
+    iter = render_caches.emplace(render_caches.begin());
+    iter->element = element;
+    render_caches_by_element.emplace(element, iter);
+    iter->layer = std::make_unique<CachedLayer>();
+    iter->layer->init(box.size().x, box.size().y, theme, fm);
+    render_cache_memory += iter->layer->memory();
+  }
+  auto& cache = *iter;
+  cache.box = box;
+  cache.used_frame = frame;
+  cache.rendered_frame = frame;
+
+  // Rendered without the masks of its ancestors, so the texture stays valid
+  // wherever it is drawn. Cached groups inside are rendered as usual.
+  struct State {
+    ElementPtr element;
+    bool first_visit;
+    State(ElementPtr element) : element(element), first_visit(true) {}
+  };
+  FrameStack<State> stack(arena.get());
+  stack.emplace(element);
+  cache_renderer.begin(box, false);
+  while (!stack.empty()) {
+    auto& state = stack.top();
+    auto iter = state.element;
+    if (!state.first_visit) {
+      cache_renderer.pop_mask();
+      stack.pop();
+      continue;
+    }
+    state.first_visit = false;
+
+    system(iter).render(iter, cache_renderer);
+    frame_stats_.counters().elements_rendered++;
+    cache_renderer.push_mask(iter.cold_state().child_mask);
+
+    const Box2& mask = cache_renderer.mask();
+    for (auto child = iter.child(); child; child = child.next()) {
+      const auto& child_state = child.state();
+      if (!child_state.hidden && !child_state.floating &&
+          intersects(mask, child_state.box())) {
+        stack.emplace(child);
+      }
+    }
+  }
+  cache_renderer.end_layer();
+  cache_renderer.end();
+
+  cache.layer->begin();
+  for (std::size_t i = 0; i < cache_renderer.layer_count(); i++) {
+    cache_renderer.render(i);
+  }
+  cache.layer->end();
+  frame_stats_.counters().cached_groups_rendered++;
+
+  // Cleared over the whole subtree, so anything in it changing marks the
+  // group again. Caches of groups inside may be out of date now.
+  FrameStack<ElementPtr> subtree(arena.get());
+  subtree.push(element);
+  while (!subtree.empty()) {
+    auto iter = subtree.top();
+    subtree.pop();
+    iter.cold_state().subtree_render_dirty = false;
+    if (iter != element && iter.type() == Type::Group &&
+        iter.group().cached) {
+      auto nested = render_caches_by_element.find(iter);
+      if (nested != render_caches_by_element.end()) {
+        erase_render_cache(nested->second);
+      }
+    }
+    for (auto child = iter.child(); child; child = child.next()) {
+      subtree.push(child);
+    }
+  }
+
+  return &cache;
+}
+
+void Gui::erase_render_cache(std::list<RenderCache>::iterator cache) {
+  render_cache_memory -= cache->layer->memory();
+  render_caches_by_element.erase(cache->element);
+  render_caches.erase(cache);
 }
 
 #ifdef DGUI_DEBUG
@@ -599,9 +1016,9 @@ void Gui::debug_render() {
     }
     state.first_visit = false;
 
-    Color debug_color = element.state().focused         ? Color::Blue()
-                        : element.state().in_focus_tree ? Color::Red()
-                                                        : Color::Green();
+    Color debug_color = element.cold_state().focused         ? Color::Blue()
+                        : element.cold_state().in_focus_tree ? Color::Red()
+                                                             : Color::Green();
     renderer.queue_box(
         Box2(
             element.state().position,
@@ -612,17 +1029,17 @@ void Gui::debug_render() {
 
     if (element.state().floating) {
       renderer.queue_box(
-          element.state().float_box,
+          element.cold_state().float_box,
           Color::Clear(),
           2,
-          element.state().in_focus_tree ? Color(1, 0, 1) : Color(0, 1, 1));
+          element.cold_state().in_focus_tree ? Color(1, 0, 1) : Color(0, 1, 1));
     }
 
     for (auto child = element.child(); child; child = child.next()) {
       layer_stack.push(child);
     }
 
-    if (element.state().focused) {
+    if (element.cold_state().focused) {
       focused = element;
     }
   }
@@ -638,7 +1055,7 @@ void Gui::debug_render() {
        << focused.state().size.y;
     ss << "\nhidden: " << (focused.state().hidden ? "true" : "false");
     if (focused.state().floating) {
-      ss << "\nfloating priority: " << focused.state().float_priority;
+      ss << "\nfloating priority: " << focused.cold_state().float_priority;
     }
     std::string debug_text = ss.str();
 
@@ -647,13 +1064,13 @@ void Gui::debug_render() {
 
     renderer.queue_box(
         Box2(
-            window.size() - text_size - Vec2::uniform(15),
-            window.size() - Vec2::uniform(5)),
+            window_.size() - text_size - Vec2::uniform(15),
+            window_.size() - Vec2::uniform(5)),
         Color::White(),
         2,
         Color::Black());
     renderer.queue_text(
-        window.size() - text_size - Vec2::uniform(10),
+        window_.size() - text_size - Vec2::uniform(10),
         debug_text,
         Font::DejaVuSans,
         24,
@@ -667,16 +1084,26 @@ void Gui::calculate_sizes() {
     return;
   }
 
-  auto prev_floating_elements = floating_elements;
+  std::pmr::unordered_set<ElementPtr, ElementPtr::HashFunc>
+      prev_floating_elements(arena.get());
+  prev_floating_elements.insert(
+      floating_elements.begin(),
+      floating_elements.end());
   floating_elements.clear();
+
+  // Elements to measure, in post-order so each comes after its children,
+  // with the size of the subtree ending at each
+  FrameVector<ElementPtr> order(arena.get());
+  FrameVector<std::size_t> subtree_sizes(arena.get());
   {
     struct State {
       ElementPtr element;
       bool first_visit;
-      State(ElementPtr element) : element(element), first_visit(true) {}
+      std::size_t begin;
+      State(ElementPtr element) :
+          element(element), first_visit(true), begin(0) {}
     };
-
-    std::stack<State> stack;
+    FrameStack<State> stack(arena.get());
     stack.emplace(tree.root());
 
     while (!stack.empty()) {
@@ -687,71 +1114,165 @@ void Gui::calculate_sizes() {
         stack.pop();
         continue;
       }
+      // Nothing inside has changed, so the sizes from a previous frame are
+      // still valid
+      if (!element.state().dirty) {
+        stack.pop();
+        continue;
+      }
 
       // If the node has children, process these first
       if (element.child() && state.first_visit) {
         state.first_visit = false;
+        state.begin = order.size();
         for (auto child = element.child(); child; child = child.next()) {
           stack.emplace(child);
         }
         continue;
       }
+      std::size_t begin = state.first_visit ? order.size() : state.begin;
       stack.pop();
 
-      set_input_state(element);
+      order.push_back(element);
+      subtree_sizes.push_back(order.size() - begin);
+    }
+  }
+
+  auto measure = [this](ElementPtr element) {
+    set_input_state(element);
+
+    auto& state = element.state();
+    state.dirty = false;
+    state.input_changed = true;
+    state.contains_floating = state.floating;
+    for (auto child = element.child(); child; child = child.next()) {
+      state.contains_floating |= child.state().contains_floating;
+    }
+  };
+  frame_stats_.counters().elements_laid_out += order.size();
+  if (!order.empty()) {
+    hit_grid.invalidate();
+  }
+
+  if (!layout_pool || order.size() < parallel_layout_min_elements) {
+    for (auto element : order) {
+      measure(element);
+    }
+  } else {
+    // Split into ranges of whole subtrees, up to grain elements each, which
+    // are independent so can be measured in parallel. The ancestors of these
+    // are measured afterwards.
+    std::size_t grain =
+        std::max<std::size_t>(order.size() / (4 * layout_pool->threads()), 1);
+    FrameVector<std::pair<std::size_t, std::size_t>> ranges(arena.get());
+    FrameVector<std::size_t> ancestors(arena.get());
+
+    // Iterating backwards from the root, the element before a subtree is its
+    // previous sibling, or an element before its parent
+    std::size_t end = order.size();
+    while (end > 0) {
+      std::size_t size = subtree_sizes[end - 1];
+      if (size > grain) {
+        ancestors.push_back(end - 1);
+        end--;
+        continue;
+      }
+      std::size_t begin = end - size;
+      if (!ranges.empty() && ranges.back().first == end &&
+          ranges.back().second - begin <= grain) {
+        ranges.back().first = begin;
+      } else {
+        ranges.emplace_back(begin, end);
+      }
+      end = begin;
+    }
+
+    layout_pool->run(ranges.size(), [&](std::size_t i) {
+      for (std::size_t j = ranges[i].first; j < ranges[i].second; j++) {
+        measure(order[j]);
+      }
+    });
+    for (auto iter = ancestors.rbegin(); iter != ancestors.rend(); iter++) {
+      measure(order[*iter]);
     }
   }
 
   {
-    std::stack<ElementPtr> stack;
+    FrameStack<ElementPtr> stack(arena.get());
     {
       auto root = tree.root();
       assert(root);
 
       // Special case: Fixed size if root is a viewport
       if (root.type() == Type::ViewportPtr) {
-        window.set_fixed_size(root.state().fixed_size);
+        window_.set_fixed_size(root.state().fixed_size);
       } else {
-        window.set_dynamic_size();
+        window_.set_dynamic_size();
       }
       root.state().position = Vec2();
-      root.state().size = window.size();
+      root.state().size = window_.size();
       stack.push(root);
     }
 
     while (!stack.empty()) {
       auto element = stack.top();
       stack.pop();
+      auto& state = element.state();
 
-      if (element.state().hidden) {
+      if (state.hidden) {
         continue;
       }
 
-      if (element.state().floating) {
+      // Still dirty if it was hidden during the first pass, so it is laid
+      // out with its old sizes and again on the next frame
+      if (state.dirty) {
+        element.set_dirty();
+      }
+
+      auto& cold_state = element.cold_state();
+      bool changed = state.input_changed ||
+                     !(state.position == cold_state.laid_out_position) ||
+                     !(state.size == cold_state.laid_out_size);
+
+      if (state.floating) {
         if (!prev_floating_elements.contains(element)) {
-          element.state().float_priority = next_float_priority++;
+          cold_state.float_priority = next_float_priority++;
         }
         floating_elements.insert(element);
 
+        Box2 float_box;
         if (auto type = std::get_if<FloatingTypeAbsolute>(
-                &element.state().floating_type)) {
-          element.state().float_box.lower =
-              window.size() / 2.f - type->size / 2.f;
-          element.state().float_box.upper =
-              window.size() / 2.f + type->size / 2.f;
+                &cold_state.floating_type)) {
+          float_box.lower = window_.size() / 2.f - type->size / 2.f;
+          float_box.upper = window_.size() / 2.f + type->size / 2.f;
         } else if (
             auto type = std::get_if<FloatingTypeRelative>(
-                &element.state().floating_type)) {
-          element.state().float_box.lower =
-              element.state().position + type->offset;
-          element.state().float_box.upper =
-              element.state().float_box.lower + type->size;
+                &cold_state.floating_type)) {
+          float_box.lower = state.position + type->offset;
+          float_box.upper = float_box.lower + type->size;
         } else {
           assert(false);
         }
+        if (!(float_box.lower == cold_state.float_box.lower) ||
+            !(float_box.upper == cold_state.float_box.upper)) {
+          cold_state.float_box = float_box;
+          changed = true;
+        }
       }
 
-      set_dependent_state(element);
+      if (changed) {
+        set_dependent_state(element);
+        frame_stats_.counters().elements_positioned++;
+        hit_grid.invalidate();
+        element.set_render_dirty();
+        state.input_changed = false;
+        cold_state.laid_out_position = state.position;
+        cold_state.laid_out_size = state.size;
+      } else if (!state.contains_floating) {
+        // Neither the input nor the box has changed, so the layout of the
+        // subtree is unchanged
+        continue;
+      }
 
       for (auto child = element.child(); child; child = child.next()) {
         stack.push(child);
@@ -765,10 +1286,20 @@ void Gui::calculate_sizes() {
   }
 }
 
-void Gui::event_handling() {
-  window.poll_events();
+void Gui::event_handling(bool wait) {
+  if (replaying_) {
+    replay_next();
+  } else if (wait) {
+    window_.wait_events(idle_timeout_);
+  } else {
+    window_.poll_events();
+  }
+  if (recording_) {
+    recording.push(window_.input());
+  }
+  auto timer = frame_stats_.start(FramePhase::Events);
 
-  for (const auto& event : window.mouse_events()) {
+  for (const auto& event : window_.mouse_events()) {
     switch (event.button) {
     case MouseButton::Left:
       event_handling_left_click(event);
@@ -784,13 +1315,13 @@ void Gui::event_handling() {
     }
   }
 
-  for (const auto& event : window.scroll_events()) {
+  for (const auto& event : window_.scroll_events()) {
     event_handling_scroll(event);
   }
 
-  event_handling_hover(window.mouse_pos());
+  event_handling_hover(window_.mouse_pos());
 
-  for (const auto& event : window.key_events()) {
+  for (const auto& event : window_.key_events()) {
     bool handled = false;
     if (event.action == KeyAction::Press) {
       switch (event.key) {
@@ -820,7 +1351,7 @@ void Gui::event_handling() {
   }
 
   if (element_focus) {
-    for (const auto& event : window.text_events()) {
+    for (const auto& event : window_.text_events()) {
       text_event(element_focus, event);
     }
   }
@@ -829,16 +1360,42 @@ void Gui::event_handling() {
     callback();
   }
   misc_events.clear();
+
+  timer.stop();
+}
+
+void Gui::replay_next() {
+  const auto& frames = replay.frames();
+  if (replay_index < frames.size() &&
+      frames[replay_index].frame == replay_frame) {
+    window_.replay_input(frames[replay_index]);
+    replay_index++;
+  } else {
+    // Frames without input aren't stored, so keep the mouse where it was
+    InputFrame input;
+    input.mouse_pos = window_.mouse_pos();
+    window_.replay_input(input);
+  }
+  replay_frame++;
 }
 
 ElementPtr Gui::get_leaf_node(const Vec2& position) {
+  if (!hit_grid.valid()) {
+    hit_grid.build(tree.root(), Box2(Vec2(), window_.size()));
+  }
+
   auto get_tree_leaf = [this, &position](ElementPtr root) -> ElementPtr {
     if (!root) {
       return ElementPtr();
     }
+    if (auto leaf = hit_grid.find(root, position)) {
+      return *leaf;
+    }
+
+    // Outside the grid, so walk the tree
     ElementPtr leaf = ElementPtr();
 
-    std::stack<ElementPtr> stack;
+    FrameStack<ElementPtr> stack(arena.get());
     stack.push(root);
 
     while (!stack.empty()) {
@@ -853,7 +1410,7 @@ ElementPtr Gui::get_leaf_node(const Vec2& position) {
         contains |= element.state().box().contains(position);
       }
       if (element.state().floating) {
-        contains |= element.state().float_box.contains(position);
+        contains |= element.cold_state().float_box.contains(position);
       }
       if (!contains) {
         continue;
@@ -937,15 +1494,25 @@ void Gui::event_handling_middle_click(const MouseEvent& event) {
 }
 
 void Gui::event_handling_hover(const Vec2& mouse_pos) {
+  auto prev_element_hover = element_hover;
   if (element_hover) {
-    element_hover.state().hovered = false;
+    element_hover.cold_state().hovered = false;
   }
 
   element_hover = get_leaf_node(mouse_pos);
+  // Hovering changes how elements are drawn, but not their layout
+  if (!(element_hover == prev_element_hover)) {
+    if (prev_element_hover) {
+      prev_element_hover.set_render_dirty();
+    }
+    if (element_hover) {
+      element_hover.set_render_dirty();
+    }
+  }
   if (!element_hover) {
     return;
   }
-  element_hover.state().hovered = true;
+  element_hover.cold_state().hovered = true;
   mouse_hover(element_hover, mouse_pos);
 }
 
@@ -964,25 +1531,27 @@ void Gui::change_tree_focus(ElementPtr from, ElementPtr to) {
   std::unordered_set<ElementPtr, ElementPtr::HashFunc> added;
 
   if (from) {
-    from.state().focused = false;
+    from.cold_state().focused = false;
     auto iter = from;
     while (iter) {
       removed.insert(iter);
-      iter.state().in_focus_tree = false;
+      iter.cold_state().in_focus_tree = false;
+      iter.set_render_dirty();
       iter = iter.parent();
     }
   }
 
   if (to) {
     bool found_floating = false;
-    to.state().focused = true;
+    to.cold_state().focused = true;
     auto iter = to;
     while (iter) {
       added.insert(iter);
-      iter.state().in_focus_tree = true;
+      iter.cold_state().in_focus_tree = true;
+      iter.set_render_dirty();
       if (!found_floating && iter.state().floating) {
         found_floating = true;
-        iter.state().float_priority = next_float_priority++;
+        iter.cold_state().float_priority = next_float_priority++;
       }
       iter = iter.parent();
     }
@@ -1044,7 +1613,9 @@ void Gui::focus_next(bool reverse) {
     next = ElementPtr();
   }
 
-  change_tree_focus(element_focus, next);
+  ElementPtr prev_element_focus = element_focus;
+  element_focus = next;
+  change_tree_focus(prev_element_focus, element_focus);
 }
 
 template <typename T>
@@ -1058,8 +1629,8 @@ T& Gui::viewport(float width, float height) {
   }
   // Renderered width/height can differ to the initial width/height
   // above - this defines the size used for the framebuffer
-  viewport.width = width;
-  viewport.height = height;
+  update(current, viewport.width, width);
+  update(current, viewport.height, height);
 
   move_down();
   viewport.viewport->begin();
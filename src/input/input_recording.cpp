@@ -0,0 +1,234 @@
+#include "datagui/input/input_recording.hpp"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace dgui {
+
+// Format, little-endian:
+// - Header: "DGIR", u8 version, varint frame count, varint recorded frames
+// - Per recorded frame: varint frame index delta, f32 mouse x/y,
+//   varint count then events, for each of mouse/scroll/key/text
+
+static constexpr char magic[4] = {'D', 'G', 'I', 'R'};
+static constexpr std::uint8_t version = 1;
+
+static void write_u8(std::ostream& os, std::uint8_t value) {
+  os.put(char(value));
+}
+
+static void write_varint(std::ostream& os, std::size_t value) {
+  while (value >= 0x80) {
+    write_u8(os, (value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  write_u8(os, value);
+}
+
+static void write_f32(std::ostream& os, float value) {
+  std::uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  for (std::size_t i = 0; i < 4; i++) {
+    write_u8(os, (bits >> (8 * i)) & 0xff);
+  }
+}
+
+static void write_vec(std::ostream& os, const Vec2& value) {
+  write_f32(os, value.x);
+  write_f32(os, value.y);
+}
+
+static std::uint8_t read_u8(std::istream& is) {
+  int value = is.get();
+  if (value == std::char_traits<char>::eof()) {
+    throw std::runtime_error("Unexpected end of input recording");
+  }
+  return value;
+}
+
+static std::size_t read_varint(std::istream& is) {
+  std::size_t value = 0;
+  for (std::size_t shift = 0; shift < 64; shift += 7) {
+    std::uint8_t byte = read_u8(is);
+    value |= std::size_t(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return value;
+    }
+  }
+  throw std::runtime_error("Invalid varint in input recording");
+}
+
+static float read_f32(std::istream& is) {
+  std::uint32_t bits = 0;
+  for (std::size_t i = 0; i < 4; i++) {
+    bits |= std::uint32_t(read_u8(is)) << (8 * i);
+  }
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+static Vec2 read_vec(std::istream& is) {
+  Vec2 value;
+  value.x = read_f32(is);
+  value.y = read_f32(is);
+  return value;
+}
+
+template <typename T>
+static T read_enum(std::istream& is, std::size_t size) {
+  std::uint8_t value = read_u8(is);
+  if (value >= size) {
+    throw std::runtime_error("Invalid enum in input recording");
+  }
+  return T(value);
+}
+
+static std::uint8_t pack_mod(const Modifiers& mod) {
+  return (mod.ctrl ? 1 : 0) | (mod.shift ? 2 : 0);
+}
+
+static Modifiers unpack_mod(std::uint8_t flags) {
+  Modifiers mod;
+  mod.ctrl = flags & 1;
+  mod.shift = flags & 2;
+  return mod;
+}
+
+void InputRecording::push(const InputFrame& input) {
+  std::size_t frame = frame_count_;
+  frame_count_++;
+
+  Vec2 prev_mouse_pos = frames_.empty() ? Vec2() : frames_.back().mouse_pos;
+  if (input.empty() && input.mouse_pos == prev_mouse_pos) {
+    return;
+  }
+  frames_.push_back(input);
+  frames_.back().frame = frame;
+}
+
+void InputRecording::write(std::ostream& os) const {
+  os.write(magic, sizeof(magic));
+  write_u8(os, version);
+  write_varint(os, frame_count_);
+  write_varint(os, frames_.size());
+
+  std::size_t prev_frame = 0;
+  for (const auto& input : frames_) {
+    write_varint(os, input.frame - prev_frame);
+    prev_frame = input.frame;
+    write_vec(os, input.mouse_pos);
+
+    write_varint(os, input.mouse_events.size());
+    for (const auto& event : input.mouse_events) {
+      write_u8(os, std::uint8_t(event.button));
+      write_u8(os, std::uint8_t(event.action));
+      write_u8(os, pack_mod(event.mod) | (event.is_double_click ? 4 : 0));
+      write_vec(os, event.position);
+      write_vec(os, event.press_position);
+    }
+
+    write_varint(os, input.scroll_events.size());
+    for (const auto& event : input.scroll_events) {
+      write_vec(os, event.position);
+      write_f32(os, event.amount);
+      write_u8(os, pack_mod(event.mod));
+    }
+
+    write_varint(os, input.key_events.size());
+    for (const auto& event : input.key_events) {
+      write_u8(os, std::uint8_t(event.key));
+      write_u8(os, std::uint8_t(event.action));
+      write_u8(os, pack_mod(event.mod));
+    }
+
+    write_varint(os, input.text_events.size());
+    for (const auto& event : input.text_events) {
+      write_u8(os, event.value);
+    }
+  }
+}
+
+void InputRecording::read(std::istream& is) {
+  clear();
+
+  char header[sizeof(magic)];
+  if (!is.read(header, sizeof(header)) ||
+      std::memcmp(header, magic, sizeof(magic)) != 0) {
+    throw std::runtime_error("Not an input recording");
+  }
+  if (read_u8(is) != version) {
+    throw std::runtime_error("Unsupported input recording version");
+  }
+  std::size_t frame_count = read_varint(is);
+  std::size_t recorded_count = read_varint(is);
+  if (recorded_count > frame_count) {
+    throw std::runtime_error("Invalid input recording frame count");
+  }
+
+  std::size_t frame = 0;
+  for (std::size_t i = 0; i < recorded_count; i++) {
+    InputFrame input;
+    frame += read_varint(is);
+    if (frame >= frame_count || (i > 0 && frame == frames_.back().frame)) {
+      throw std::runtime_error("Invalid input recording frame index");
+    }
+    input.frame = frame;
+    input.mouse_pos = read_vec(is);
+
+    input.mouse_events.resize(read_varint(is));
+    for (auto& event : input.mouse_events) {
+      event.button = read_enum<MouseButton>(is, MouseButtonSize);
+      event.action = read_enum<MouseAction>(is, 3);
+      std::uint8_t flags = read_u8(is);
+      event.mod = unpack_mod(flags);
+      event.is_double_click = flags & 4;
+      event.position = read_vec(is);
+      event.press_position = read_vec(is);
+    }
+
+    input.scroll_events.resize(read_varint(is));
+    for (auto& event : input.scroll_events) {
+      event.position = read_vec(is);
+      event.amount = read_f32(is);
+      event.mod = unpack_mod(read_u8(is));
+    }
+
+    input.key_events.resize(read_varint(is));
+    for (auto& event : input.key_events) {
+      event.key = read_enum<Key>(is, std::size_t(Key::Z) + 1);
+      event.action = read_enum<KeyAction>(is, 3);
+      event.mod = unpack_mod(read_u8(is));
+      event.glfw_window = nullptr;
+    }
+
+    input.text_events.resize(read_varint(is));
+    for (auto& event : input.text_events) {
+      event.value = read_u8(is);
+    }
+
+    frames_.push_back(std::move(input));
+  }
+  frame_count_ = frame_count;
+}
+
+void InputRecording::save(const std::string& path) const {
+  std::ofstream file(path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("Failed to open " + path);
+  }
+  write(file);
+}
+
+void InputRecording::load(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("Failed to open " + path);
+  }
+  read(file);
+}
+
+} // namespace dgui
@@ -21,19 +21,20 @@ void ButtonSystem::set_input_state(ElementPtr element) {
 
 void ButtonSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
   const auto& state = element.state();
+  const auto& cold_state = element.cold_state();
   const auto& button = element.button();
 
   Color bg_color;
   if (button.down) {
     bg_color = theme->input_color_bg_active;
-  } else if (state.hovered) {
+  } else if (cold_state.hovered) {
     bg_color = theme->input_color_bg_hover;
   } else {
     bg_color = theme->input_color_bg;
   }
 
   Color border_color;
-  if (state.in_focus_tree) {
+  if (cold_state.in_focus_tree) {
     border_color = theme->input_color_border_focus;
   } else {
     border_color = theme->input_color_border;
@@ -61,44 +62,44 @@ void ButtonSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
       LengthWrap());
 }
 
-void ButtonSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
+bool ButtonSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
   const auto& state = element.state();
   auto& button = element.button();
 
   if (event.button != MouseButton::Left) {
-    return;
+    return false;
   }
   switch (event.action) {
   case MouseAction::Press:
     button.down = true;
-    break;
+    return true;
   case MouseAction::Release:
     button.down = false;
     if (state.box().contains(event.position)) {
       button.released = true;
     }
-    break;
+    return true;
   default:
-    break;
+    return false;
   }
 }
 
-void ButtonSystem::key_event(ElementPtr element, const KeyEvent& event) {
+bool ButtonSystem::key_event(ElementPtr element, const KeyEvent& event) {
   auto& button = element.button();
   if (event.key != Key::Enter) {
-    return;
+    return false;
   }
 
   switch (event.action) {
   case KeyAction::Press:
     button.down = true;
-    break;
+    return true;
   case KeyAction::Release:
     button.down = false;
     button.released = true;
-    break;
+    return true;
   default:
-    break;
+    return false;
   }
 }
 
@@ -37,7 +37,7 @@ void CheckboxSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
   renderer.queue_box(icon_box, theme->input_color_bg_active);
 }
 
-void CheckboxSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
+bool CheckboxSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
   const auto& state = element.state();
   auto& checkbox = element.checkbox();
 
@@ -45,16 +45,20 @@ void CheckboxSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
       event.button == MouseButton::Left) {
     checkbox.checked = !checkbox.checked;
     checkbox.changed = true;
+    return true;
   }
+  return false;
 }
 
-void CheckboxSystem::key_event(ElementPtr element, const KeyEvent& event) {
+bool CheckboxSystem::key_event(ElementPtr element, const KeyEvent& event) {
   auto& checkbox = element.checkbox();
 
   if (event.action == KeyAction::Release && event.key == Key::Enter) {
     checkbox.checked = !checkbox.checked;
     checkbox.changed = true;
+    return true;
   }
+  return false;
 }
 
 } // namespace dgui
@@ -18,6 +18,7 @@ void CollapsableSystem::set_input_state(ElementPtr element) {
   layout_set_input_state(
       element,
       theme,
+      *arena,
       collapsable.layout,
       collapsable.layout_state);
 
@@ -73,10 +74,11 @@ void CollapsableSystem::set_dependent_state(ElementPtr element) {
       element,
       collapsable.content_box,
       theme,
+      *arena,
       collapsable.layout,
       collapsable.layout_state);
 
-  state.child_mask = collapsable.content_box;
+  element.cold_state().child_mask = collapsable.content_box;
 }
 
 void CollapsableSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
@@ -122,7 +124,7 @@ void CollapsableSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
       renderer);
 }
 
-void CollapsableSystem::mouse_event(
+bool CollapsableSystem::mouse_event(
     ElementPtr element,
     const MouseEvent& event) {
   const auto& state = element.state();
@@ -133,13 +135,15 @@ void CollapsableSystem::mouse_event(
       state.position + Vec2(state.size.x, collapsable.header_size.y));
 
   if (!header_box.contains(event.position)) {
-    return;
+    return false;
   }
 
   if (event.action == MouseAction::Release &&
       event.button == MouseButton::Left) {
     collapsable.open = !collapsable.open;
+    return true;
   }
+  return false;
 }
 
 bool CollapsableSystem::scroll_event(
@@ -152,12 +156,14 @@ bool CollapsableSystem::scroll_event(
       event);
 }
 
-void CollapsableSystem::key_event(ElementPtr element, const KeyEvent& event) {
+bool CollapsableSystem::key_event(ElementPtr element, const KeyEvent& event) {
   auto& collapsable = element.collapsable();
 
   if (event.action == KeyAction::Release && event.key == Key::Enter) {
     collapsable.open = !collapsable.open;
+    return true;
   }
+  return false;
 }
 
 } // namespace dgui
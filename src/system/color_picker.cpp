@@ -24,12 +24,13 @@ void ColorPickerSystem::set_input_state(ElementPtr element) {
   Vec2 float_size(3 * p + 2 * r + w, 2 * p + 2 * r);
 
   state.floating = color_picker.open;
-  state.floating_type = FloatingTypeRelative(float_offset, float_size);
   state.float_only = false;
+  element.cold_state().floating_type =
+      FloatingTypeRelative(float_offset, float_size);
 }
 
 void ColorPickerSystem::set_dependent_state(ElementPtr element) {
-  auto& state = element.state();
+  const auto& cold_state = element.cold_state();
   auto& color_picker = element.color_picker();
 
   const float r = theme->color_picker_hue_wheel_radius;
@@ -37,13 +38,13 @@ void ColorPickerSystem::set_dependent_state(ElementPtr element) {
   const float w = theme->color_picker_value_scale_width;
 
   {
-    Vec2 origin = state.float_box.lower + Vec2::uniform(p);
+    Vec2 origin = cold_state.float_box.lower + Vec2::uniform(p);
     Vec2 size = Vec2::uniform(2 * r);
     color_picker.hue_wheel_box = Box2(origin, origin + size);
   }
 
   {
-    Vec2 origin = state.float_box.lower + Vec2(2 * p + 2 * r, p);
+    Vec2 origin = cold_state.float_box.lower + Vec2(2 * p + 2 * r, p);
     Vec2 size = Vec2(w, 2 * r);
     color_picker.lightness_box = Box2(origin, origin + size);
   }
@@ -51,9 +52,10 @@ void ColorPickerSystem::set_dependent_state(ElementPtr element) {
 
 void ColorPickerSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
   const auto& state = element.state();
+  const auto& cold_state = element.cold_state();
   auto& color_picker = element.color_picker();
 
-  const auto& color = state.focused ? active_color : color_picker.value;
+  const auto& color = cold_state.focused ? active_color : color_picker.value;
 
   renderer.queue_box(state.box(), color, 2, theme->input_color_border);
 
@@ -63,7 +65,11 @@ void ColorPickerSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
 
   Color bg_color = color;
   bg_color.a = 0.5;
-  renderer.queue_box(state.float_box, bg_color, 2, theme->layout_border_color);
+  renderer.queue_box(
+      cold_state.float_box,
+      bg_color,
+      2,
+      theme->layout_border_color);
 
   float lightness = color.lightness();
   struct Pixel {
@@ -148,7 +154,7 @@ void ColorPickerSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
   }
 }
 
-void ColorPickerSystem::mouse_event(
+bool ColorPickerSystem::mouse_event(
     ElementPtr element,
     const MouseEvent& event) {
   const auto& state = element.state();
@@ -160,18 +166,19 @@ void ColorPickerSystem::mouse_event(
     if (!color_picker.open) {
       color_picker.open = true;
       active_color = color_picker.value;
-      return;
+      return true;
     }
     if (color_picker.modified) {
       color_picker.modified = false;
       color_picker.changed = true;
       color_picker.value = active_color;
     }
-    return;
+    return true;
   }
   if (!color_picker.open) {
-    return;
+    return false;
   }
+  Color prev_color = active_color;
 
   Vec2 hue_wheel_offset = event.position - color_picker.hue_wheel_box.center();
 
@@ -208,15 +215,23 @@ void ColorPickerSystem::mouse_event(
     color_picker.modified = true;
   }
 
+  // Holding the mouse still generates a hold event every poll, which
+  // shouldn't count as a change
+  if (active_color == prev_color) {
+    return event.action == MouseAction::Press;
+  }
   if (color_picker.modified && color_picker.always) {
     color_picker.changed = true;
     color_picker.value = active_color;
   }
+  return true;
 }
 
-void ColorPickerSystem::focus_tree_leave(ElementPtr element) {
+bool ColorPickerSystem::focus_tree_leave(ElementPtr element) {
   auto& color_picker = element.color_picker();
+  bool was_open = color_picker.open;
   color_picker.open = false;
+  return was_open;
 }
 
 } // namespace dgui
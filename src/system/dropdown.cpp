@@ -21,6 +21,7 @@ void DropdownSystem::set_input_state(ElementPtr element) {
   layout_set_input_state(
       element,
       theme,
+      *arena,
       dropdown.layout,
       dropdown.layout_state);
 
@@ -28,30 +29,32 @@ void DropdownSystem::set_input_state(ElementPtr element) {
   state.float_only = false;
 
   if (state.floating) {
+    auto& cold_state = element.cold_state();
     Vec2 offset;
     if (dropdown.direction == Direction::Horizontal) {
       offset = Vec2(state.fixed_size.x, 0);
     } else {
       offset = Vec2(0, state.fixed_size.y);
     }
-    state.floating_type =
+    cold_state.floating_type =
         FloatingTypeRelative(offset, dropdown.layout_state.content_fixed_size);
   }
 }
 
 void DropdownSystem::set_dependent_state(ElementPtr element) {
-  auto& state = element.state();
+  auto& cold_state = element.cold_state();
   auto& dropdown = element.dropdown();
 
   if (!dropdown.open) {
     return;
   }
 
-  state.child_mask = state.float_box;
+  cold_state.child_mask = cold_state.float_box;
   layout_set_dependent_state(
       element,
-      state.float_box,
+      cold_state.float_box,
       theme,
+      *arena,
       dropdown.layout,
       dropdown.layout_state);
 }
@@ -78,41 +81,51 @@ void DropdownSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
       theme->text_color);
 
   if (dropdown.open) {
-    renderer.queue_box(state.float_box, theme->layout_color_bg);
+    const auto& cold_state = element.cold_state();
+    renderer.queue_box(cold_state.float_box, theme->layout_color_bg);
     layout_render_scroll(
-        state.float_box,
+        cold_state.float_box,
         dropdown.layout_state,
         theme,
         renderer);
   }
 }
 
-void DropdownSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
+bool DropdownSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
   auto& dropdown = element.dropdown();
-  if (event.action == MouseAction::Press) {
+  if (event.action == MouseAction::Press && !dropdown.open) {
     dropdown.open = true;
+    return true;
   }
+  return false;
 }
 
 bool DropdownSystem::scroll_event(
     ElementPtr element,
     const ScrollEvent& event) {
-  const auto& state = element.state();
+  const auto& cold_state = element.cold_state();
   auto& dropdown = element.dropdown();
   if (!dropdown.open) {
     return false;
   }
-  return layout_scroll_event(state.float_box, dropdown.layout_state, event);
+  return layout_scroll_event(
+      cold_state.float_box,
+      dropdown.layout_state,
+      event);
 }
 
-void DropdownSystem::focus_enter(ElementPtr element) {
+bool DropdownSystem::focus_enter(ElementPtr element) {
   auto& dropdown = element.dropdown();
+  bool was_open = dropdown.open;
   dropdown.open = true;
+  return !was_open;
 }
 
-void DropdownSystem::focus_tree_leave(ElementPtr element) {
+bool DropdownSystem::focus_tree_leave(ElementPtr element) {
   auto& dropdown = element.dropdown();
+  bool was_open = dropdown.open;
   dropdown.open = false;
+  return was_open;
 }
 
 } // namespace dgui
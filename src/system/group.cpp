@@ -7,7 +7,12 @@ void GroupSystem::set_input_state(ElementPtr element) {
   auto& state = element.state();
   auto& group = element.group();
 
-  layout_set_input_state(element, theme, group.layout, group.layout_state);
+  layout_set_input_state(
+      element,
+      theme,
+      *arena,
+      group.layout,
+      group.layout_state);
 
   state.fixed_size = group.layout_state.content_fixed_size;
   state.dynamic_size = group.layout_state.content_dynamic_size;
@@ -41,12 +46,13 @@ void GroupSystem::set_dependent_state(ElementPtr element) {
     group.content_box.lower += Vec2::uniform(theme->layout_border_width);
     group.content_box.upper -= Vec2::uniform(theme->layout_border_width);
   }
-  state.child_mask = group.content_box;
+  element.cold_state().child_mask = group.content_box;
 
   layout_set_dependent_state(
       element,
       group.content_box,
       theme,
+      *arena,
       group.layout,
       group.layout_state);
 }
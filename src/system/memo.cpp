@@ -0,0 +1,36 @@
+#include "datagui/system/memo.hpp"
+#include "datagui/system_utils/layout.hpp"
+
+namespace dgui {
+
+void MemoSystem::set_input_state(ElementPtr element) {
+  auto& state = element.state();
+  auto& memo = element.memo();
+
+  layout_set_input_state(
+      element,
+      theme,
+      *arena,
+      memo.layout,
+      memo.layout_state);
+
+  state.fixed_size = memo.layout_state.content_fixed_size;
+  state.dynamic_size = memo.layout_state.content_dynamic_size;
+  state.floating = false;
+}
+
+void MemoSystem::set_dependent_state(ElementPtr element) {
+  auto& state = element.state();
+  auto& memo = element.memo();
+
+  element.cold_state().child_mask = state.box();
+  layout_set_dependent_state(
+      element,
+      state.box(),
+      theme,
+      *arena,
+      memo.layout,
+      memo.layout_state);
+}
+
+} // namespace dgui
@@ -19,50 +19,57 @@ void PopupSystem::set_input_state(ElementPtr element) {
   popup.header_height = fm->text_height(theme->text_font, theme->text_size) +
                         2 * theme->text_padding;
 
-  layout_set_input_state(element, theme, popup.layout, popup.layout_state);
+  layout_set_input_state(
+      element,
+      theme,
+      *arena,
+      popup.layout,
+      popup.layout_state);
 
-  state.floating_type =
+  element.cold_state().floating_type =
       FloatingTypeAbsolute(Vec2(popup.popup_size.x, popup.popup_size.y));
 }
 
 void PopupSystem::set_dependent_state(ElementPtr element) {
-  auto& state = element.state();
+  auto& cold_state = element.cold_state();
   auto& popup = element.popup();
 
   if (!popup.open) {
     return;
   }
 
-  popup.header_box.lower = state.float_box.lower;
-  popup.header_box.upper.x = state.float_box.upper.x;
-  popup.header_box.upper.y = state.float_box.lower.y + popup.header_height;
+  popup.header_box.lower = cold_state.float_box.lower;
+  popup.header_box.upper.x = cold_state.float_box.upper.x;
+  popup.header_box.upper.y =
+      cold_state.float_box.lower.y + popup.header_height;
 
   Vec2 x_size =
       fm->text_size("x", theme->text_font, theme->text_size, LengthWrap()) +
       Vec2::uniform(2 * theme->text_padding);
 
-  popup.close_button_box.lower.x = state.float_box.upper.x - x_size.x;
-  popup.close_button_box.lower.y = state.float_box.lower.y;
+  popup.close_button_box.lower.x = cold_state.float_box.upper.x - x_size.x;
+  popup.close_button_box.lower.y = cold_state.float_box.lower.y;
   popup.close_button_box.upper = popup.close_button_box.lower + x_size;
 
   popup.header_text_width = std::max(
-      state.float_box.size().x - x_size.x - 2.f * theme->text_padding,
+      cold_state.float_box.size().x - x_size.x - 2.f * theme->text_padding,
       0.f);
 
-  popup.content_box = state.float_box;
+  popup.content_box = cold_state.float_box;
   popup.content_box.lower.y += popup.header_height;
-  state.child_mask = popup.content_box;
+  cold_state.child_mask = popup.content_box;
 
   layout_set_dependent_state(
       element,
       popup.content_box,
       theme,
+      *arena,
       popup.layout,
       popup.layout_state);
 }
 
 void PopupSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
-  const auto& state = element.state();
+  const auto& cold_state = element.cold_state();
   const auto& popup = element.popup();
 
   if (!popup.open) {
@@ -74,11 +81,11 @@ void PopupSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
   const Color& bg_color =
       popup.bg_color ? *popup.bg_color : theme->layout_color_bg;
 
-  renderer.queue_box(state.float_box, bg_color);
+  renderer.queue_box(cold_state.float_box, bg_color);
   renderer.queue_box(popup.header_box, header_color);
 
   renderer.queue_text(
-      state.float_box.lower +
+      cold_state.float_box.lower +
           Vec2::uniform(theme->input_border_width + theme->text_padding),
       popup.title,
       theme->text_font,
@@ -99,13 +106,15 @@ void PopupSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
   layout_render_scroll(popup.content_box, popup.layout_state, theme, renderer);
 }
 
-void PopupSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
+bool PopupSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
   auto& popup = element.popup();
 
   if (event.action == MouseAction::Release &&
       popup.close_button_box.contains(event.position)) {
     popup.close_button_released = true;
+    return true;
   }
+  return false;
 }
 
 bool PopupSystem::scroll_event(ElementPtr element, const ScrollEvent& event) {
@@ -32,7 +32,8 @@ void SelectSystem::set_input_state(ElementPtr element) {
     floating_offset.x = 0;
     floating_offset.y = state.fixed_size.y - theme->input_border_width;
 
-    state.floating_type = FloatingTypeRelative(floating_offset, floating_size);
+    element.cold_state().floating_type =
+        FloatingTypeRelative(floating_offset, floating_size);
   } else {
     state.floating = false;
   }
@@ -45,7 +46,7 @@ void SelectSystem::set_dependent_state(ElementPtr element) {
   select.choice_boxes.resize(select.choices.size());
 
   Vec2 size = state.box().size();
-  Vec2 position = state.float_box.lower;
+  Vec2 position = element.cold_state().float_box.lower;
   for (std::size_t i = 0; i < select.choices.size(); i++) {
     auto& box = select.choice_boxes[i];
     box = Box2(position, position + size);
@@ -104,20 +105,20 @@ void SelectSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
   }
 }
 
-void SelectSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
+bool SelectSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
   const auto& state = element.state();
   auto& select = element.select();
 
   if (event.action != MouseAction::Press) {
-    return;
+    return false;
   }
 
   if (!select.open) {
     select.open = true;
-    return;
+    return true;
   }
   if (select.choices.empty()) {
-    return;
+    return false;
   }
 
   for (std::size_t i = 0; i < select.choices.size(); i++) {
@@ -125,20 +126,26 @@ void SelectSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
       if (i != select.choice) {
         select.choice = i;
         select.changed = true;
+        return true;
       }
-      return;
+      return false;
     }
   }
+  return false;
 }
 
-void SelectSystem::focus_enter(ElementPtr element) {
+bool SelectSystem::focus_enter(ElementPtr element) {
   auto& select = element.select();
+  bool was_open = select.open;
   select.open = true;
+  return !was_open;
 }
 
-void SelectSystem::focus_leave(ElementPtr element, bool success) {
+bool SelectSystem::focus_leave(ElementPtr element, bool success) {
   auto& select = element.select();
+  bool was_open = select.open;
   select.open = false;
+  return was_open;
 }
 
 } // namespace dgui
@@ -77,7 +77,7 @@ void SliderSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
       theme->text_color);
 }
 
-void SliderSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
+bool SliderSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
   const auto& state = element.state();
   auto& slider = element.slider();
 
@@ -85,11 +85,12 @@ void SliderSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
     if (event.action == MouseAction::Release) {
       slider.value = slider.initial_value;
       slider.changed = true;
+      return true;
     }
-    return;
+    return false;
   }
   if (event.button != MouseButton::Left) {
-    return;
+    return false;
   }
 
   if (!slider.held && event.action == MouseAction::Press) {
@@ -111,8 +112,9 @@ void SliderSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
     if (slider_box.contains(event.position)) {
       active_value = slider.value;
       slider.held = true;
+      return true;
     }
-    return;
+    return false;
   }
   if (slider.held && event.action == MouseAction::Release) {
     slider.held = false;
@@ -120,11 +122,12 @@ void SliderSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
       slider.value = active_value;
       slider.changed = true;
     }
-    return;
+    return true;
   }
   if (!slider.held || event.action != MouseAction::Hold) {
-    return;
+    return false;
   }
+  double prev_value = active_value;
 
   float slider_length =
       slider.length ? *slider.length : theme->slider_default_length;
@@ -160,10 +163,14 @@ void SliderSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
     break;
   }
 
+  if (active_value == prev_value) {
+    return false;
+  }
   if (slider.always) {
     slider.value = active_value;
     slider.changed = true;
   }
+  return true;
 }
 
 std::string SliderSystem::get_slider_text(const Slider& slider) const {
@@ -72,7 +72,7 @@ void SplitSystem::set_dependent_state(ElementPtr element) {
   auto& state = element.state();
   auto& split = element.split();
 
-  state.child_mask = state.box();
+  element.cold_state().child_mask = state.box();
 
   auto first = element.child();
   while (first && first.state().float_only) {
@@ -170,24 +170,28 @@ void SplitSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
   renderer.queue_box(split.divider_box, color);
 }
 
-void SplitSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
+bool SplitSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
   const auto& state = element.state();
   auto& split = element.split();
 
   if (event.action == MouseAction::Release) {
+    bool was_held = split.held;
     split.held = false;
+    return was_held;
   }
   if (event.action == MouseAction::Press) {
     if (split.divider_box.contains(event.position)) {
       // Allow held=true for fixed split too, to visually show it is held,
       // but don't update the ratio
       split.held = true;
+      return true;
     }
-    return;
+    return false;
   }
   if (!split.held || split.fixed) {
-    return;
+    return false;
   }
+  float prev_ratio = split.ratio;
 
   if (split.direction == Direction::Horizontal) {
     split.ratio = std::clamp(
@@ -200,6 +204,7 @@ void SplitSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
         0.f,
         1.f);
   }
+  return split.ratio != prev_ratio;
 }
 
 } // namespace dgui
@@ -46,16 +46,12 @@ void TabsSystem::set_dependent_state(ElementPtr element) {
   auto& state = element.state();
   auto& tabs = element.tabs();
 
-  for (auto& box : tabs.label_boxes) {
-    box.lower += state.position;
-    box.upper += state.position;
-  }
+  auto& child_mask = element.cold_state().child_mask;
+  child_mask = state.box();
+  child_mask.lower.y += tabs.header_height;
 
-  state.child_mask = state.box();
-  state.child_mask.lower.y += tabs.header_height;
-
-  Vec2 child_pos = state.child_mask.lower;
-  Vec2 child_full_size = state.child_mask.size();
+  Vec2 child_pos = child_mask.lower;
+  Vec2 child_full_size = child_mask.size();
 
   auto child = element.child();
   std::size_t i = 0;
@@ -100,7 +96,9 @@ void TabsSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
   for (std::size_t i = 0; i < tabs.labels.size(); i++) {
     const Color& bg_color =
         (i == tabs.tab) ? theme->input_color_bg_active : theme->input_color_bg;
-    const auto& box = tabs.label_boxes[i];
+    Box2 box = tabs.label_boxes[i];
+    box.lower += state.position;
+    box.upper += state.position;
     renderer.queue_box(
         box,
         bg_color,
@@ -116,22 +114,24 @@ void TabsSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
   }
 }
 
-void TabsSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
+bool TabsSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
   const auto& state = element.state();
   auto& tabs = element.tabs();
 
   if (event.action != MouseAction::Press) {
-    return;
+    return false;
   }
 
   for (std::size_t i = 0; i < tabs.labels.size(); i++) {
-    if (tabs.label_boxes[i].contains(event.position)) {
+    if (tabs.label_boxes[i].contains(event.position - state.position)) {
       if (i != tabs.tab) {
         tabs.tab = i;
+        return true;
       }
-      return;
+      return false;
     }
   }
+  return false;
 }
 
 } // namespace dgui
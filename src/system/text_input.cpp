@@ -6,7 +6,8 @@ void TextInputSystem::set_input_state(ElementPtr element) {
   auto& state = element.state();
   auto& text_input = element.text_input();
 
-  const std::string& text = state.focused ? active_text : text_input.text;
+  const std::string& text =
+      element.cold_state().focused ? active_text : text_input.text;
   Length text_length = text_input.width
                            ? *text_input.width
                            : LengthFixed(theme->text_input_default_width);
@@ -29,12 +30,13 @@ void TextInputSystem::set_input_state(ElementPtr element) {
 
 void TextInputSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
   const auto& state = element.state();
+  const auto& cold_state = element.cold_state();
   const auto& text_input = element.text_input();
 
-  const std::string& text = state.focused ? active_text : text_input.text;
+  const std::string& text = cold_state.focused ? active_text : text_input.text;
 
   Color border_color;
-  if (state.in_focus_tree) {
+  if (cold_state.in_focus_tree) {
     border_color = theme->input_color_border_focus;
   } else {
     border_color = theme->input_color_border;
@@ -54,7 +56,7 @@ void TextInputSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
                            ? *text_input.width
                            : LengthFixed(theme->text_input_default_width);
 
-  if (state.focused) {
+  if (cold_state.focused) {
     render_selection(
         text,
         text_position,
@@ -84,7 +86,7 @@ void TextInputSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
   renderer.pop_mask();
 }
 
-void TextInputSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
+bool TextInputSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
   const auto& state = element.state();
   const auto& text_input = element.text_input();
 
@@ -106,12 +108,17 @@ void TextInputSystem::mouse_event(ElementPtr element, const MouseEvent& event) {
 
   if (event.action == MouseAction::Press) {
     active_selection.reset(cursor_pos);
-  } else if (event.action == MouseAction::Hold) {
+    return true;
+  }
+  if (event.action == MouseAction::Hold &&
+      active_selection.end != cursor_pos) {
     active_selection.end = cursor_pos;
+    return true;
   }
+  return false;
 }
 
-void TextInputSystem::key_event(ElementPtr element, const KeyEvent& event) {
+bool TextInputSystem::key_event(ElementPtr element, const KeyEvent& event) {
   auto& text_input = element.text_input();
 
   if (event.action == KeyAction::Press && event.key == Key::Enter) {
@@ -121,35 +128,42 @@ void TextInputSystem::key_event(ElementPtr element, const KeyEvent& event) {
         active_text = text_input.text;
         active_selection.reset(
             std::min(active_selection.begin, active_text.size()));
-        return;
+        return true;
       }
       text_input.text = active_text;
       text_input.changed = true;
+      return true;
     }
-    return;
+    return false;
   }
 
+  std::string prev_text = active_text;
+  TextSelection prev_selection = active_selection;
   selection_key_event(
       active_text,
       active_selection,
       text_input.editable,
       event);
+  return active_text != prev_text || active_selection != prev_selection;
 }
 
-void TextInputSystem::text_event(ElementPtr element, const TextEvent& event) {
+bool TextInputSystem::text_event(ElementPtr element, const TextEvent& event) {
   const auto& text_input = element.text_input();
+  std::string prev_text = active_text;
+  TextSelection prev_selection = active_selection;
   selection_text_event(
       active_text,
       active_selection,
       text_input.editable,
       event);
+  return active_text != prev_text || active_selection != prev_selection;
 }
 
 bool TextInputSystem::scroll_event(
     ElementPtr element,
     const ScrollEvent& event) {
   auto& text_input = element.text_input();
-  const auto& state = element.state();
+  const auto& cold_state = element.cold_state();
 
   if (!text_input.number_type.has_value()) {
     return false;
@@ -170,11 +184,11 @@ bool TextInputSystem::scroll_event(
     scroll_amount *= 10;
   }
 
-  const std::string& text = state.focused ? active_text : text_input.text;
+  const std::string& text = cold_state.focused ? active_text : text_input.text;
   double value = 0;
   text_to_number(text, value);
   value += scroll_amount;
-  if (state.focused) {
+  if (cold_state.focused) {
     active_text = std::to_string(value);
   } else {
     text_input.text = std::to_string(value);
@@ -184,23 +198,26 @@ bool TextInputSystem::scroll_event(
   return true;
 }
 
-void TextInputSystem::focus_enter(ElementPtr element) {
+bool TextInputSystem::focus_enter(ElementPtr element) {
   const auto& text_input = element.text_input();
 
   active_selection.reset(0);
   active_text = text_input.text;
+  // The focused text input shows active_text, which changes its layout
+  return true;
 }
 
-void TextInputSystem::focus_leave(ElementPtr element, bool success) {
+bool TextInputSystem::focus_leave(ElementPtr element, bool success) {
   auto& text_input = element.text_input();
   if (success && text_input.text != active_text) {
     if (text_input.number_type &&
         !valid_text_to_number(*text_input.number_type, active_text)) {
-      return;
+      return true;
     }
     text_input.text = active_text;
     text_input.changed = true;
   }
+  return true;
 }
 
 } // namespace dgui
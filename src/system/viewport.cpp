@@ -19,7 +19,7 @@ void ViewportPtrSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
       viewport.viewport->texture());
 }
 
-void ViewportPtrSystem::mouse_event(
+bool ViewportPtrSystem::mouse_event(
     ElementPtr element,
     const MouseEvent& event) {
   const auto& state = element.state();
@@ -31,6 +31,15 @@ void ViewportPtrSystem::mouse_event(
   remapped.position.y = 1 - remapped.position.y;
   remapped.press_position.y = 1 - remapped.press_position.y;
   viewport.viewport->mouse_event(remapped);
+
+  // The viewport may redraw on any event, but a hold event with the mouse
+  // still can't change anything
+  auto& hold_position = hold_positions[std::size_t(event.button)];
+  if (event.action == MouseAction::Hold && event.position == hold_position) {
+    return false;
+  }
+  hold_position = event.position;
+  return true;
 }
 
 bool ViewportPtrSystem::scroll_event(
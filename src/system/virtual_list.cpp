@@ -0,0 +1,88 @@
+#include "datagui/system/virtual_list.hpp"
+#include "datagui/system_utils/layout.hpp"
+
+namespace dgui {
+
+void VirtualListSystem::set_input_state(ElementPtr element) {
+  auto& state = element.state();
+  auto& list = element.virtual_list();
+
+  // Only the rows in view are children, so the width fits these
+  float width = 0;
+  for (auto child = element.child(); child; child = child.next()) {
+    width = std::max(width, child.state().fixed_size.x);
+  }
+  list.layout_state.content_fixed_size =
+      Vec2(width, list.count * list.row_height);
+  list.layout_state.content_dynamic_size = Vec2();
+
+  state.fixed_size = Vec2(width, list.row_height);
+  state.dynamic_size = Vec2();
+  state.floating = false;
+
+  if (auto width = std::get_if<LengthFixed>(&list.width)) {
+    state.fixed_size.x = width->value;
+  } else if (auto width = std::get_if<LengthDynamic>(&list.width)) {
+    state.dynamic_size.x = width->weight;
+  }
+  if (auto height = std::get_if<LengthFixed>(&list.height)) {
+    state.fixed_size.y = height->value;
+  } else if (auto height = std::get_if<LengthDynamic>(&list.height)) {
+    state.dynamic_size.y = height->weight;
+  }
+}
+
+void VirtualListSystem::set_dependent_state(ElementPtr element) {
+  auto& state = element.state();
+  auto& list = element.virtual_list();
+  auto& layout_state = list.layout_state;
+
+  list.content_box = state.box();
+  element.cold_state().child_mask = list.content_box;
+
+  Vec2 size = list.content_box.size();
+  layout_state.content_overrun =
+      maximum(layout_state.content_fixed_size - size, Vec2());
+  layout_state.scroll_pos.x = std::clamp(
+      layout_state.scroll_pos.x,
+      0.f,
+      layout_state.content_overrun.x);
+  layout_state.scroll_pos.y = std::clamp(
+      layout_state.scroll_pos.y,
+      0.f,
+      layout_state.content_overrun.y);
+
+  // Position relative to the first row, to avoid losing precision with
+  // large row indices
+  Vec2 origin = list.content_box.lower;
+  origin.x -= layout_state.scroll_pos.x;
+  origin.y += list.first_row * list.row_height - layout_state.scroll_pos.y;
+
+  std::size_t i = 0;
+  for (auto child = element.child(); child; child = child.next()) {
+    auto& c_state = child.state();
+    c_state.hidden = false;
+    c_state.position = origin + Vec2(0, i * list.row_height);
+    if (c_state.dynamic_size.x > 0) {
+      c_state.size.x = std::max(size.x, c_state.fixed_size.x);
+    } else {
+      c_state.size.x = c_state.fixed_size.x;
+    }
+    c_state.size.y = list.row_height;
+    i++;
+  }
+}
+
+void VirtualListSystem::render(ConstElementPtr element, GuiRenderer& renderer) {
+  const auto& list = element.virtual_list();
+  layout_render_scroll(list.content_box, list.layout_state, theme, renderer);
+}
+
+bool VirtualListSystem::scroll_event(
+    ElementPtr element,
+    const ScrollEvent& event) {
+  auto& list = element.virtual_list();
+  return layout_scroll_event(list.content_box, list.layout_state, event);
+}
+
+} // namespace dgui
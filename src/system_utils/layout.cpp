@@ -5,6 +5,7 @@ namespace dgui {
 void layout_set_input_state(
     ElementPtr element,
     const std::shared_ptr<Theme>& theme,
+    FrameArena& arena,
     const Layout& layout,
     LayoutState& state) {
 
@@ -31,7 +32,7 @@ void layout_set_input_state(
     std::size_t j;
     ElementPtr element;
   };
-  std::vector<MultiCell> multi_cells;
+  FrameVector<MultiCell> multi_cells(&arena);
 
   auto child = element.child();
   std::size_t i = 0;
@@ -150,10 +151,11 @@ void layout_set_dependent_state(
     ElementPtr element,
     const Box2& content_box,
     const std::shared_ptr<Theme>& theme,
+    FrameArena& arena,
     const Layout& layout,
     LayoutState& state) {
 
-  std::vector<float> col_sizes(state.col_input_sizes.size());
+  FrameVector<float> col_sizes(state.col_input_sizes.size(), &arena);
   {
     float size = content_box.size().x;
     float content_size = state.content_fixed_size.x;
@@ -170,7 +172,7 @@ void layout_set_dependent_state(
     }
   }
 
-  std::vector<float> row_sizes(state.row_input_sizes.size());
+  FrameVector<float> row_sizes(state.row_input_sizes.size(), &arena);
   {
     float size = content_box.size().y;
     float content_size = state.content_fixed_size.y;
@@ -187,6 +189,13 @@ void layout_set_dependent_state(
     }
   }
 
+  // In case size has changed. Clamped before positioning the children, since
+  // these aren't positioned again unless something else changes.
+  state.scroll_pos.x =
+      std::clamp(state.scroll_pos.x, 0.f, state.content_overrun.x);
+  state.scroll_pos.y =
+      std::clamp(state.scroll_pos.y, 0.f, state.content_overrun.y);
+
   bool row_major = (layout.cols > 0);
 
   float outer_padding = layout.tight ? 0.f : theme->layout_outer_padding;
@@ -306,16 +315,6 @@ void layout_set_dependent_state(
     child.state().hidden = true;
     child = child.next();
   }
-
-  // In case size has changed
-  state.scroll_pos.x = std::clamp(
-      state.scroll_pos.x,
-      0.f,
-      std::max(state.content_overrun.x, 0.f));
-  state.scroll_pos.y = std::clamp(
-      state.scroll_pos.y,
-      0.f,
-      std::max(state.content_overrun.y, 0.f));
 }
 
 void layout_render_scroll(
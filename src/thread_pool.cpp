@@ -0,0 +1,115 @@
+#include "datagui/thread_pool.hpp"
+#include <assert.h>
+
+namespace dgui {
+
+ThreadPool::ThreadPool(std::size_t threads) {
+  assert(threads > 0);
+  for (std::size_t i = 0; i < threads; i++) {
+    queues.push_back(std::make_unique<Queue>());
+  }
+  // The last queue is used by the calling thread
+  for (std::size_t i = 0; i + 1 < threads; i++) {
+    workers.emplace_back([this, i]() { worker(i); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  start_cv.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::run(
+    std::size_t count,
+    const std::function<void(std::size_t)>& task) {
+  if (count == 0) {
+    return;
+  }
+  for (std::size_t i = 0; i < count; i++) {
+    auto& queue = *queues[i % queues.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(i);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->task = &task;
+    error = nullptr;
+    active = workers.size();
+    batch++;
+  }
+  start_cv.notify_all();
+  run_tasks(queues.size() - 1);
+
+  // Once every worker has finished, no task is still running
+  std::unique_lock<std::mutex> lock(mutex);
+  done_cv.wait(lock, [this]() { return active == 0; });
+  this->task = nullptr;
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void ThreadPool::worker(std::size_t queue) {
+  std::size_t prev_batch = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      start_cv.wait(lock, [&]() { return stopping || batch != prev_batch; });
+      if (stopping) {
+        return;
+      }
+      prev_batch = batch;
+    }
+    run_tasks(queue);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      active--;
+    }
+    done_cv.notify_one();
+  }
+}
+
+void ThreadPool::run_tasks(std::size_t queue) {
+  std::size_t i;
+  while (next_task(queue, i)) {
+    try {
+      (*task)(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+}
+
+bool ThreadPool::next_task(std::size_t queue, std::size_t& index) {
+  {
+    auto& own = *queues[queue];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      index = own.tasks.back();
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+  for (std::size_t i = 1; i < queues.size(); i++) {
+    auto& other = *queues[(queue + i) % queues.size()];
+    std::lock_guard<std::mutex> lock(other.mutex);
+    if (!other.tasks.empty()) {
+      index = other.tasks.front();
+      other.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace dgui
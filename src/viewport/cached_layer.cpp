@@ -0,0 +1,13 @@
+#include "datagui/viewport/cached_layer.hpp"
+
+namespace dgui {
+
+void CachedLayer::begin() {
+  bind_framebuffer(Color::Clear());
+}
+
+void CachedLayer::end() {
+  unbind_framebuffer();
+}
+
+} // namespace dgui
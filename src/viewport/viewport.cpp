@@ -3,7 +3,14 @@
 
 namespace dgui {
 
-Viewport::Viewport() : width(0), height(0), texture_(0), framebuffer(0) {}
+Viewport::Viewport(bool transparent) :
+    width(0),
+    height(0),
+    texture_(0),
+    framebuffer(0),
+    render_buffer(0),
+    prev_framebuffer(0),
+    transparent(transparent) {}
 
 Viewport::~Viewport() {
   if (texture_ > 0) {
@@ -12,16 +19,23 @@ Viewport::~Viewport() {
   if (framebuffer > 0) {
     glDeleteFramebuffers(1, &framebuffer);
   }
+  if (render_buffer > 0) {
+    glDeleteRenderbuffers(1, &render_buffer);
+  }
 }
 
 Viewport::Viewport(Viewport&& other) {
   width = other.width;
-  height = other.width;
+  height = other.height;
   texture_ = other.texture_;
   framebuffer = other.framebuffer;
+  render_buffer = other.render_buffer;
+  prev_framebuffer = other.prev_framebuffer;
+  transparent = other.transparent;
 
   other.texture_ = 0;
   other.framebuffer = 0;
+  other.render_buffer = 0;
 }
 
 void Viewport::init(
@@ -39,11 +53,11 @@ void Viewport::init(
   glTexImage2D(
       GL_TEXTURE_2D,
       0,
-      GL_RGB,
+      transparent ? GL_RGBA8 : GL_RGB,
       width,
       height,
       0,
-      GL_RGB,
+      transparent ? GL_RGBA : GL_RGB,
       GL_UNSIGNED_BYTE,
       0);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -51,7 +65,11 @@ void Viewport::init(
   glBindTexture(GL_TEXTURE_2D, 0);
 
   // Create a framebuffer and bind a texture to it
+  // The current framebuffer is restored afterwards, since this may be
+  // created while rendering to the window
 
+  int prev_framebuffer;
+  glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prev_framebuffer);
   glGenFramebuffers(1, &framebuffer);
   glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
   glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, texture_, 0);
@@ -70,6 +88,7 @@ void Viewport::init(
   assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
 
   glBindRenderbuffer(GL_RENDERBUFFER, 0);
+  glBindFramebuffer(GL_FRAMEBUFFER, prev_framebuffer);
 
   // Initialise child class
 
@@ -77,14 +96,24 @@ void Viewport::init(
 }
 
 void Viewport::bind_framebuffer(const Color& bg_color) {
+  // Restored afterwards, since this isn't the default framebuffer when
+  // the window is headless
+  int prev_framebuffer;
+  glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prev_framebuffer);
+  this->prev_framebuffer = prev_framebuffer;
+
   glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
   glViewport(0, 0, width, height);
-  glClearColor(bg_color.r, bg_color.g, bg_color.b, 1.f);
+  glClearColor(
+      bg_color.r,
+      bg_color.g,
+      bg_color.b,
+      transparent ? bg_color.a : 1.f);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
 void Viewport::unbind_framebuffer() {
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glBindFramebuffer(GL_FRAMEBUFFER, prev_framebuffer);
   glBindFramebuffer(GL_DEPTH_BUFFER, 0);
 }
 
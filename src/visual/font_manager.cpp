@@ -5,6 +5,8 @@
 #include <GLFW/glfw3.h>
 #include <algorithm>
 #include <filesystem>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 
@@ -90,22 +92,12 @@ std::string find_font_path(Font font) {
   return candidates.front();
 }
 
-FontStructure load_font(Font font, int font_size) {
+// Reads the character metrics, which doesn't require a GL context, so can
+// be called from any thread
+static FontStructure load_font_metrics(Font font, int font_size) {
   FontStructure structure;
   structure.resize(' ', '~');
 
-  // Keep track of these values to restore afterwards
-
-  int original_fb;
-  glGetIntegerv(GL_FRAMEBUFFER_BINDING, &original_fb);
-
-  int original_fb_w, original_fb_h;
-  int original_viewport[4];
-  glGetIntegerv(GL_VIEWPORT, original_viewport);
-
-  unsigned char original_blend;
-  glGetBooleanv(GL_BLEND, &original_blend);
-
   // Initialise ft_library
 
   FT_Library ft_library;
@@ -159,6 +151,46 @@ FontStructure load_font(Font font, int font_size) {
     texture_row_width += character.advance;
   }
 
+  FT_Done_Face(ft_face);
+  FT_Done_FreeType(ft_library);
+
+  structure.font_texture_width = texture_width;
+  structure.font_texture_height = texture_height;
+  return structure;
+}
+
+// Renders the characters to the font texture and sets their uv coordinates,
+// using the metrics from load_font_metrics()
+static void load_font_texture(
+    FontStructure& structure,
+    Font font,
+    int font_size) {
+  const std::size_t texture_width = structure.font_texture_width;
+  const std::size_t texture_height = structure.font_texture_height;
+
+  // Keep track of these values to restore afterwards
+
+  int original_fb;
+  glGetIntegerv(GL_FRAMEBUFFER_BINDING, &original_fb);
+
+  int original_viewport[4];
+  glGetIntegerv(GL_VIEWPORT, original_viewport);
+
+  unsigned char original_blend;
+  glGetBooleanv(GL_BLEND, &original_blend);
+
+  FT_Library ft_library;
+  if (FT_Init_FreeType(&ft_library) != 0) {
+    throw std::runtime_error("Failed to initialize freetype library");
+  }
+
+  FT_Face ft_face;
+  if (FT_New_Face(ft_library, find_font_path(font).c_str(), 0, &ft_face) != 0) {
+    throw std::runtime_error("Failed to load font");
+  }
+
+  FT_Set_Pixel_Sizes(ft_face, 0, font_size);
+
   // Load shader program and buffers
 
   struct Vertex {
@@ -338,29 +370,50 @@ FontStructure load_font(Font font, int font_size) {
 
   FT_Done_Face(ft_face);
   FT_Done_FreeType(ft_library);
-
-  structure.font_texture_width = texture_width;
-  structure.font_texture_height = texture_height;
-  return structure;
 }
 
 const FontStructure& FontManager::font_structure(Font font, int font_size) {
-  auto iter = fonts.find(std::make_pair(font, font_size));
-  if (iter != fonts.end()) {
-    return iter->second;
+  auto& structure = font_metrics(font, font_size);
+  if (structure.font_texture == 0) {
+    load_font_texture(structure, font, font_size);
   }
-  auto new_font = fonts.emplace(
-      std::make_pair(font, font_size),
-      load_font(font, font_size));
-  return new_font.first->second;
+  return structure;
 };
 
+FontStructure& FontManager::font_metrics(Font font, int font_size) {
+  auto key = std::make_pair(font, font_size);
+  {
+    std::shared_lock<std::shared_mutex> lock(fonts_mutex);
+    auto iter = fonts.find(key);
+    if (iter != fonts.end()) {
+      return iter->second;
+    }
+  }
+  // Loaded without the lock, so if another thread loads the same font, the
+  // first one inserted is kept
+  auto structure = load_font_metrics(font, font_size);
+  std::unique_lock<std::shared_mutex> lock(fonts_mutex);
+  return fonts.emplace(key, std::move(structure)).first->second;
+}
+
 Vec2 FontManager::text_size(
     const std::string& text,
     Font font,
     int font_size,
     Length width) {
-  const auto& fs = font_structure(font, font_size);
+  auto key = text_key(text, font, font_size, width);
+  auto& shard = text_shard(key);
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto entry = find_text(shard, key, text);
+    if (entry && entry->size) {
+      shard.stats.hits++;
+      return *entry->size;
+    }
+    shard.stats.misses++;
+  }
+
+  const auto& fs = font_metrics(font, font_size);
 
   auto fixed_width = std::get_if<LengthFixed>(&width);
 
@@ -387,30 +440,53 @@ Vec2 FontManager::text_size(
     pos.x += character.advance;
   }
 
+  Vec2 size;
   if (fixed_width) {
-    return Vec2(fixed_width->value, pos.y);
+    size = Vec2(fixed_width->value, pos.y);
   } else {
-    return Vec2(std::max(line_break_max_x, pos.x), pos.y);
+    size = Vec2(std::max(line_break_max_x, pos.x), pos.y);
   }
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  insert_text(shard, key, text).size = size;
+  evict_text(shard);
+  return size;
 }
 
 float FontManager::text_height(Font font, int font_size) {
-  const auto& fs = font_structure(font, font_size);
+  const auto& fs = font_metrics(font, font_size);
   return fs.line_height;
 }
 
-std::vector<FontManager::Character> FontManager::text_characters(
+std::pmr::vector<FontManager::Character> FontManager::text_characters(
     const std::string& text,
     Font font,
     int font_size,
-    Length width) {
+    Length width,
+    std::pmr::memory_resource* memory) {
+  auto key = text_key(text, font, font_size, width);
+  auto& shard = text_shard(key);
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto entry = find_text(shard, key, text);
+    if (entry && entry->characters) {
+      shard.stats.hits++;
+      return std::pmr::vector<Character>(
+          entry->characters->begin(),
+          entry->characters->end(),
+          memory);
+    }
+    shard.stats.misses++;
+  }
+
   const auto& fs = font_structure(font, font_size);
 
   auto fixed_width = std::get_if<LengthFixed>(&width);
   Vec2 offset;
   offset.y -= fs.line_height;
 
-  std::vector<Character> characters;
+  std::pmr::vector<Character> characters(memory);
+  characters.reserve(text.size());
   for (char c_char : text) {
     if (c_char == '\n') {
       offset.x = 0;
@@ -433,7 +509,96 @@ std::vector<FontManager::Character> FontManager::text_characters(
 
     offset.x += c.advance;
   }
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  insert_text(shard, key, text)
+      .characters.emplace(characters.begin(), characters.end());
+  evict_text(shard);
   return characters;
 }
 
+FontManager::TextCacheStats FontManager::text_cache_stats() {
+  TextCacheStats result;
+  for (auto& shard : text_shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    result.hits += shard.stats.hits;
+    result.misses += shard.stats.misses;
+    result.evictions += shard.stats.evictions;
+  }
+  return result;
+}
+
+void FontManager::reset_text_cache_stats() {
+  for (auto& shard : text_shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.stats = TextCacheStats();
+  }
+}
+
+void FontManager::set_text_cache_capacity(std::size_t capacity) {
+  text_shard_capacity =
+      (capacity + text_shards.size() - 1) / text_shards.size();
+  for (auto& shard : text_shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    evict_text(shard);
+  }
+}
+
+FontManager::TextKey FontManager::text_key(
+    const std::string& text,
+    Font font,
+    int font_size,
+    Length width) {
+  TextKey key;
+  key.text_hash = std::hash<std::string>()(text);
+  key.font = font;
+  key.font_size = font_size;
+  auto fixed_width = std::get_if<LengthFixed>(&width);
+  key.width = fixed_width ? fixed_width->value : -1;
+  return key;
+}
+
+FontManager::TextShard& FontManager::text_shard(const TextKey& key) {
+  return text_shards[TextKey::HashFunc()(key) % text_shards.size()];
+}
+
+FontManager::TextEntry* FontManager::find_text(
+    TextShard& shard,
+    const TextKey& key,
+    const std::string& text) {
+  auto iter = shard.entries_by_key.find(key);
+  if (iter == shard.entries_by_key.end()) {
+    return nullptr;
+  }
+  auto entry = iter->second;
+  shard.entries.splice(shard.entries.begin(), shard.entries, entry);
+  // Different text with the same hash, so replace it
+  if (entry->text != text) {
+    entry->text = text;
+    entry->size.reset();
+    entry->characters.reset();
+  }
+  return &(*entry);
+}
+
+FontManager::TextEntry& FontManager::insert_text(
+    TextShard& shard,
+    const TextKey& key,
+    const std::string& text) {
+  if (auto entry = find_text(shard, key, text)) {
+    return *entry;
+  }
+  shard.entries.emplace_front(key, text);
+  shard.entries_by_key.emplace(key, shard.entries.begin());
+  return shard.entries.front();
+}
+
+void FontManager::evict_text(TextShard& shard) {
+  while (shard.entries.size() > text_shard_capacity) {
+    shard.entries_by_key.erase(shard.entries.back().key);
+    shard.entries.pop_back();
+    shard.stats.evictions++;
+  }
+}
+
 } // namespace dgui
@@ -0,0 +1,625 @@
+#include "datagui/visual/gui_batcher.hpp"
+#include "datagui/visual/shader_utils.hpp"
+#include <GL/glew.h>
+#include <algorithm>
+#include <assert.h>
+#include <cstring>
+#include <string>
+
+namespace dgui {
+
+const static std::string vertex_shader = R"(
+#version 330 core
+
+layout(location = 0) in vec2 corner;
+layout(location = 1) in vec2 box_lower;
+layout(location = 2) in vec2 box_upper;
+layout(location = 3) in vec2 coords_lower;
+layout(location = 4) in vec2 coords_upper;
+layout(location = 5) in vec4 color;
+layout(location = 6) in vec4 border_color;
+layout(location = 7) in vec2 border_width;
+layout(location = 8) in vec2 radius;
+layout(location = 9) in int primitive;
+layout(location = 10) in int slot;
+
+uniform mat3 PV;
+
+out vec2 fs_coords;
+
+flat out vec4 fs_color;
+flat out vec4 fs_border_color;
+flat out vec2 fs_border_width;
+flat out vec2 fs_radius;
+flat out int fs_primitive;
+flat out int fs_slot;
+
+void main() {
+  // Written out rather than using mix(), so corners are exact
+  vec2 pos = box_lower * (1 - corner) + box_upper * corner;
+  vec3 coords = PV * vec3(pos, 1);
+  gl_Position = vec4(coords.xy / coords.z, 0, 1);
+
+  fs_coords = coords_lower * (1 - corner) + coords_upper * corner;
+  fs_color = color;
+  fs_border_color = border_color;
+  fs_border_width = border_width;
+  fs_radius = radius;
+  fs_primitive = primitive;
+  fs_slot = slot;
+}
+)";
+
+const static std::string fragment_shader = R"(
+#version 330 core
+
+in vec2 fs_coords;
+flat in vec4 fs_color;
+flat in vec4 fs_border_color;
+flat in vec2 fs_border_width;
+flat in vec2 fs_radius;
+flat in int fs_primitive;
+flat in int fs_slot;
+
+uniform sampler2D tex[8];
+
+out vec4 color;
+
+// Sampler arrays can only be indexed by constants
+vec4 sample_texture(vec2 uv) {
+  if (fs_slot == 0) return texture(tex[0], uv);
+  if (fs_slot == 1) return texture(tex[1], uv);
+  if (fs_slot == 2) return texture(tex[2], uv);
+  if (fs_slot == 3) return texture(tex[3], uv);
+  if (fs_slot == 4) return texture(tex[4], uv);
+  if (fs_slot == 5) return texture(tex[5], uv);
+  if (fs_slot == 6) return texture(tex[6], uv);
+  return texture(tex[7], uv);
+}
+
+void main() {
+  if (fs_primitive == 1) {
+    color = vec4(fs_color.xyz, sample_texture(fs_coords).x * fs_color.a);
+    return;
+  }
+  if (fs_primitive == 2) {
+    color = sample_texture(fs_coords);
+    return;
+  }
+  if (fs_primitive == 3) {
+    // Undo the premultiplication, to be blended as usual
+    vec4 cached = sample_texture(fs_coords);
+    color = cached.a > 0 ? vec4(cached.rgb / cached.a, cached.a) : vec4(0);
+    return;
+  }
+
+  vec2 size = vec2(0.5, 0.5);
+  vec2 pos = abs(fs_coords);
+  vec2 arc_origin = size - fs_radius;
+  vec2 arc_pos = pos - arc_origin;
+
+  if (fs_radius.x > 0 && fs_radius.y > 0
+      && arc_pos.x >= 0 && arc_pos.y >= 0)
+  {
+    vec2 arc_pos_outer = arc_pos / fs_radius;
+    vec2 arc_pos_inner = arc_pos / (fs_radius - fs_border_width);
+
+    if (length(arc_pos_outer) > 1) {
+      discard;
+    } else if (length(arc_pos_inner) > 1) {
+      color = fs_border_color;
+    } else {
+      color = fs_color;
+    }
+  } else {
+    if (pos.x > size.x || pos.y > size.y) {
+      discard;
+    }
+    if (pos.x > size.x - fs_border_width.x
+        || pos.y > size.y - fs_border_width.y) {
+      color = fs_border_color;
+    } else {
+      color = fs_color;
+    }
+  }
+}
+)";
+
+void GuiBatcher::init(
+    const std::shared_ptr<FontManager>& fm,
+    const std::shared_ptr<FrameArena>& arena) {
+  this->fm = fm;
+  this->arena = arena;
+
+  program_id = create_program(vertex_shader, fragment_shader);
+  uniform_PV = glGetUniformLocation(program_id, "PV");
+
+  // Each texture unit is fixed to one sampler
+  glUseProgram(program_id);
+  for (std::size_t i = 0; i < max_textures; i++) {
+    std::string name = "tex[" + std::to_string(i) + "]";
+    glUniform1i(glGetUniformLocation(program_id, name.c_str()), i);
+  }
+  glUseProgram(0);
+
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &static_VBO);
+
+  glBindVertexArray(VAO);
+
+  // Corners of the quad in [0, 1], split along the same diagonal as the
+  // other shaders
+  const std::vector<Vec2> static_vertices = {
+      Vec2(0, 0),
+      Vec2(1, 0),
+      Vec2(0, 1),
+      Vec2(1, 0),
+      Vec2(1, 1),
+      Vec2(0, 1)};
+  static_vertex_count = static_vertices.size();
+
+  glBindBuffer(GL_ARRAY_BUFFER, static_VBO);
+  glBufferData(
+      GL_ARRAY_BUFFER,
+      static_vertices.size() * sizeof(Vec2),
+      static_vertices.data(),
+      GL_STATIC_DRAW);
+
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vec2), (void*)0);
+  glEnableVertexAttribArray(0);
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindVertexArray(0);
+}
+
+void GuiBatcher::set_instance_attributes(
+    unsigned int buffer,
+    std::size_t offset) {
+  glBindBuffer(GL_ARRAY_BUFFER, buffer);
+  GLuint index = 1;
+
+  auto float_attribute = [&](int size, std::size_t attribute_offset) {
+    glVertexAttribPointer(
+        index,
+        size,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(Instance),
+        (void*)(offset + attribute_offset));
+    glVertexAttribDivisor(index, 1);
+    glEnableVertexAttribArray(index);
+    index++;
+  };
+  auto int_attribute = [&](std::size_t attribute_offset) {
+    glVertexAttribIPointer(
+        index,
+        1,
+        GL_INT,
+        sizeof(Instance),
+        (void*)(offset + attribute_offset));
+    glVertexAttribDivisor(index, 1);
+    glEnableVertexAttribArray(index);
+    index++;
+  };
+
+  float_attribute(2, offsetof(Instance, box) + offsetof(Box2, lower));
+  float_attribute(2, offsetof(Instance, box) + offsetof(Box2, upper));
+  float_attribute(2, offsetof(Instance, coords) + offsetof(Box2, lower));
+  float_attribute(2, offsetof(Instance, coords) + offsetof(Box2, upper));
+  float_attribute(4, offsetof(Instance, color));
+  float_attribute(4, offsetof(Instance, border_color));
+  float_attribute(2, offsetof(Instance, border_width));
+  float_attribute(2, offsetof(Instance, radius));
+  int_attribute(offsetof(Instance, primitive));
+  int_attribute(offsetof(Instance, slot));
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+GuiBatcher::Instance& GuiBatcher::queue(
+    Primitive primitive,
+    unsigned int texture) {
+  instance_textures.push_back(texture);
+  instance_sources.push_back(no_source);
+  auto& instance = instances.emplace_back();
+  instance.primitive = int(primitive);
+  instance.slot = 0;
+  return instance;
+}
+
+void GuiBatcher::queue_masked_box(
+    const Box2& mask,
+    const Box2& box,
+    const Color& color,
+    float border_width,
+    Color border_color,
+    float radius) {
+  if (box.empty()) {
+    return;
+  }
+  Box2 region = intersection(mask, box);
+  if (region.empty()) {
+    return;
+  }
+
+  // Model coords of the visible region, so the shape is cut off at the
+  // mask rather than drawn whole
+  Vec2 center = box.center();
+  Vec2 size = box.size();
+  auto& instance = queue(Primitive::Shape, 0);
+  instance.box = region;
+  instance.coords.lower = (region.lower - center) / size;
+  instance.coords.upper = (region.upper - center) / size;
+  instance.color = color;
+  instance.border_color = border_color;
+  instance.border_width = Vec2::uniform(border_width) / size;
+  instance.radius = Vec2::uniform(radius) / size;
+}
+
+void GuiBatcher::queue_masked_text(
+    const Box2& mask,
+    const Vec2& origin,
+    const std::string& text,
+    Font font,
+    int font_size,
+    Color text_color,
+    Length width) {
+
+  auto characters = fm->text_characters(
+      text,
+      font,
+      font_size,
+      width,
+      arena ? arena.get() : std::pmr::get_default_resource());
+  unsigned int font_texture = fm->font_structure(font, font_size).font_texture;
+
+  for (auto& [box, uv] : characters) {
+    box.lower += origin;
+    box.upper += origin;
+    if (!intersects(mask, box)) {
+      continue;
+    }
+    if (!contains(mask, box)) {
+      // Partially obscured -> alter box and uv
+      Box2 new_box = intersection(mask, box);
+      Box2 new_uv;
+      new_uv.lower.x = uv.lower.x + uv.size().x *
+                                        (new_box.lower.x - box.lower.x) /
+                                        box.size().x;
+      new_uv.lower.y = uv.lower.y + uv.size().y *
+                                        (new_box.lower.y - box.lower.y) /
+                                        box.size().y;
+      new_uv.upper.x = uv.lower.x + uv.size().x *
+                                        (new_box.upper.x - box.lower.x) /
+                                        box.size().x;
+      new_uv.upper.y = uv.lower.y + uv.size().y *
+                                        (new_box.upper.y - box.lower.y) /
+                                        box.size().y;
+      box = new_box;
+      uv = new_uv;
+    }
+
+    auto& instance = queue(Primitive::Glyph, font_texture);
+    instance.box = box;
+    instance.coords = uv;
+    instance.color = text_color;
+  }
+}
+
+void GuiBatcher::queue_masked_image(
+    const Box2& mask,
+    const Image& image,
+    const Vec2& position,
+    const Vec2& size) {
+  if (!image.is_loaded()) {
+    return;
+  }
+  assert(image.data->texture > 0);
+
+  Box2 region = intersection(mask, Box2(position, position + size));
+  if (region.empty()) {
+    return;
+  }
+  Box2 uv;
+  uv.lower = (region.lower - position) / size;
+  uv.upper = (region.upper - position) / size;
+
+  // Y flipped
+  uv.lower.y = 1 - uv.lower.y;
+  uv.upper.y = 1 - uv.upper.y;
+
+  auto& instance = queue(Primitive::Image, image.data->texture);
+  instance.box = region;
+  instance.coords = uv;
+}
+
+void GuiBatcher::queue_viewport(
+    const Box2& mask,
+    const Box2& box,
+    int texture) {
+  if (texture == 0) {
+    return;
+  }
+
+  Box2 region = intersection(mask, box);
+  if (region.empty()) {
+    return;
+  }
+  Box2 uv;
+  uv.lower = (region.lower - box.lower) / box.size();
+  uv.upper = (region.upper - box.lower) / box.size();
+
+  auto& instance = queue(Primitive::Image, texture);
+  instance.box = region;
+  instance.coords = uv;
+}
+
+void GuiBatcher::queue_cached(
+    const Box2& mask,
+    const Box2& box,
+    int texture) {
+  Box2 region = intersection(mask, box);
+  if (region.empty()) {
+    return;
+  }
+  Box2 uv;
+  uv.lower = (region.lower - box.lower) / box.size();
+  uv.upper = (region.upper - box.lower) / box.size();
+
+  auto& instance = queue(Primitive::Cached, texture);
+  instance.box = region;
+  instance.coords = uv;
+}
+
+void GuiBatcher::end_layer() {
+  if (layer_index == layers.size()) {
+    layers.emplace_back().buffer.init();
+  }
+  auto& layer = layers[layer_index];
+  std::size_t begin = layer_begin;
+  std::size_t end = instances.size();
+
+  layer.unchanged = replayed_size == end && layer.frame + 1 == frame_ &&
+                    replay_begin == layer.begin && replay_end == layer.end;
+  layer.frame = frame_;
+  layer.begin = begin;
+  layer.end = end;
+
+  layer_index++;
+  layer_begin = end;
+  replayed_size = end;
+  replay_begin = 0;
+  replay_end = 0;
+}
+
+void GuiBatcher::draw(
+    std::size_t index,
+    const Box2& viewport,
+    const Camera2d& camera,
+    const Box2& scissor) {
+  assert(index < layer_index);
+  auto& layer = layers[index];
+  std::size_t begin = layer.begin;
+  std::size_t end = layer.end;
+  if (begin == end) {
+    layer.batches.clear();
+    return;
+  }
+
+  for (std::size_t i = begin; i < end; i++) {
+    primitives_drawn_[instances[i].primitive]++;
+  }
+
+  if (scissor.empty()) {
+    // Nothing to draw, so nothing uploaded unless it already was
+    if (!layer.unchanged) {
+      layer.frame = 0;
+    }
+    return;
+  }
+
+  if (layer.unchanged) {
+    // Already uploaded, with the texture units assigned
+    layers_reused_++;
+  } else {
+    // Split into runs of instances whose textures fit in the texture units,
+    // assigning each textured instance its unit
+    layer.batches.clear();
+    layer.batches.push_back({begin, 0, {}, 0});
+    for (std::size_t i = begin; i < end; i++) {
+      unsigned int texture = instance_textures[i];
+      if (texture > 0) {
+        Batch* batch = &layer.batches.back();
+        auto textures_begin = batch->textures.begin();
+        auto textures_end = textures_begin + batch->texture_count;
+        auto iter = std::find(textures_begin, textures_end, texture);
+        if (iter == textures_end && batch->texture_count == max_textures) {
+          batch = &layer.batches.emplace_back(Batch{i, 0, {}, 0});
+          iter = batch->textures.begin();
+        }
+        if (iter == batch->textures.begin() + batch->texture_count) {
+          *iter = texture;
+          batch->texture_count++;
+        }
+        instances[i].slot = iter - batch->textures.begin();
+      }
+      layer.batches.back().count++;
+    }
+    for (auto& batch : layer.batches) {
+      batch.first -= begin;
+    }
+
+    layer.offset = layer.buffer.write(
+        instances.data() + begin,
+        (end - begin) * sizeof(Instance),
+        sizeof(Instance),
+        stats_);
+  }
+
+  glViewport(
+      viewport.lower.x,
+      viewport.lower.y,
+      viewport.upper.x - viewport.lower.x,
+      viewport.upper.y - viewport.lower.y);
+
+  glEnable(GL_SCISSOR_TEST);
+  glScissor(
+      scissor.lower.x,
+      scissor.lower.y,
+      scissor.upper.x - scissor.lower.x,
+      scissor.upper.y - scissor.lower.y);
+
+  // Alpha is accumulated as coverage, so drawing to a transparent texture
+  // leaves it premultiplied
+  glEnable(GL_BLEND);
+  glBlendFuncSeparate(
+      GL_SRC_ALPHA,
+      GL_ONE_MINUS_SRC_ALPHA,
+      GL_ONE,
+      GL_ONE_MINUS_SRC_ALPHA);
+  glDisable(GL_CULL_FACE);
+  glDisable(GL_DEPTH_TEST);
+
+  Mat3 V = camera.view_mat();
+  Mat3 P = camera.projection_mat();
+  Mat3 PV = P * V;
+
+  glBindVertexArray(VAO);
+  glUseProgram(program_id);
+  glUniformMatrix3fv(uniform_PV, 1, GL_FALSE, PV.data);
+
+  for (const auto& batch : layer.batches) {
+    for (std::size_t i = 0; i < batch.texture_count; i++) {
+      glActiveTexture(GL_TEXTURE0 + i);
+      glBindTexture(GL_TEXTURE_2D, batch.textures[i]);
+    }
+    // Instanced draws can't start from an instance offset in GL 3.3, so
+    // move the attributes instead
+    set_instance_attributes(
+        layer.buffer.id(),
+        layer.offset + batch.first * sizeof(Instance));
+    glDrawArraysInstanced(
+        GL_TRIANGLES,
+        0,
+        static_vertex_count,
+        batch.count);
+
+    stats_.instances += batch.count;
+    stats_.draw_calls++;
+  }
+
+  for (std::size_t i = 0; i < max_textures; i++) {
+    glActiveTexture(GL_TEXTURE0 + i);
+    glBindTexture(GL_TEXTURE_2D, 0);
+  }
+  glActiveTexture(GL_TEXTURE0);
+  glBindVertexArray(0);
+  glUseProgram(0);
+  glDisable(GL_SCISSOR_TEST);
+}
+
+void GuiBatcher::next_frame() {
+  std::swap(instances, prev_instances);
+  std::swap(instance_textures, prev_instance_textures);
+  instances.clear();
+  instance_textures.clear();
+  instance_sources.clear();
+  frame_++;
+
+  layer_index = 0;
+  layer_begin = 0;
+  replayed_size = 0;
+  replay_begin = 0;
+  replay_end = 0;
+}
+
+bool GuiBatcher::replay(std::size_t frame, std::size_t begin, std::size_t end) {
+  if (frame + 1 != frame_ || end > prev_instances.size()) {
+    return false;
+  }
+  if (begin == end) {
+    return true;
+  }
+
+  if (instances.size() == layer_begin) {
+    replay_begin = begin;
+    replay_end = end;
+    replayed_size = layer_begin + end - begin;
+  } else if (instances.size() == replayed_size && begin == replay_end) {
+    replay_end = end;
+    replayed_size += end - begin;
+  }
+
+  instances.insert(
+      instances.end(),
+      prev_instances.begin() + begin,
+      prev_instances.begin() + end);
+  instance_textures.insert(
+      instance_textures.end(),
+      prev_instance_textures.begin() + begin,
+      prev_instance_textures.begin() + end);
+  for (std::size_t i = begin; i < end; i++) {
+    instance_sources.push_back(i);
+  }
+  return true;
+}
+
+bool GuiBatcher::replay_if_same(
+    std::size_t frame,
+    std::size_t begin,
+    std::size_t end,
+    std::size_t queued_begin) {
+  if (frame + 1 != frame_ || end > prev_instances.size() ||
+      end - begin != instances.size() - queued_begin) {
+    return false;
+  }
+  for (std::size_t i = 0; i < end - begin; i++) {
+    // The texture unit is only assigned once drawn
+    if (std::memcmp(
+            &instances[queued_begin + i],
+            &prev_instances[begin + i],
+            offsetof(Instance, slot)) != 0 ||
+        instance_textures[queued_begin + i] !=
+            prev_instance_textures[begin + i]) {
+      return false;
+    }
+  }
+
+  instances.resize(queued_begin);
+  instance_textures.resize(queued_begin);
+  instance_sources.resize(queued_begin);
+  return replay(frame, begin, end);
+}
+
+Box2 GuiBatcher::damage() const {
+  Box2 damage;
+  auto add = [&damage](const Box2& box) {
+    damage = damage.empty() ? box : bounding(damage, box);
+  };
+
+  // Where no instance below is damaged, the same instances of the previous
+  // frame are drawn there in the same order
+  std::size_t prev_end = 0;
+  for (std::size_t i = 0; i < instances.size(); i++) {
+    std::size_t source = instance_sources[i];
+    if (source == no_source || source < prev_end) {
+      add(instances[i].box);
+      continue;
+    }
+    // Skipped over, so no longer drawn
+    for (std::size_t j = prev_end; j < source; j++) {
+      add(prev_instances[j].box);
+    }
+    prev_end = source + 1;
+    // Textures may have been drawn to since
+    if (instances[i].primitive == int(Primitive::Image)) {
+      add(instances[i].box);
+    }
+  }
+  for (std::size_t j = prev_end; j < prev_instances.size(); j++) {
+    add(prev_instances[j].box);
+  }
+  return damage;
+}
+
+} // namespace dgui
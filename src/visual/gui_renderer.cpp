@@ -1,15 +1,16 @@
 #include "datagui/visual/gui_renderer.hpp"
 #include <GLFW/glfw3.h>
 #include <assert.h>
+#include <cmath>
 #include <memory>
 #include <stack>
 
 namespace dgui {
 
-void GuiRenderer::init(std::shared_ptr<FontManager> fm) {
-  shape_shader.init();
-  text_shader.init(fm);
-  image_shader.init();
+void GuiRenderer::init(
+    std::shared_ptr<FontManager> fm,
+    std::shared_ptr<FrameArena> arena) {
+  batcher.init(fm, arena);
   this->fm = fm;
 }
 
@@ -20,7 +21,7 @@ void GuiRenderer::queue_box(
     Color border_color,
     float radius) {
   assert(!masks.empty());
-  shape_shader.queue_masked_box(
+  batcher.queue_masked_box(
       flip_box(masks.top()),
       flip_box(box),
       bg_color,
@@ -37,7 +38,7 @@ void GuiRenderer::queue_text(
     Color text_color,
     Length width) {
   assert(!masks.empty());
-  text_shader.queue_masked_text(
+  batcher.queue_masked_text(
       flip_box(masks.top()),
       flip_position(origin),
       text,
@@ -48,7 +49,7 @@ void GuiRenderer::queue_text(
 }
 
 void GuiRenderer::queue_image(const Box2& box, const Image& image) {
-  image_shader.queue_masked_image(
+  batcher.queue_masked_image(
       flip_box(masks.top()),
       image,
       flip_position(box.upper_left()),
@@ -56,11 +57,19 @@ void GuiRenderer::queue_image(const Box2& box, const Image& image) {
 }
 
 void GuiRenderer::queue_viewport(const Box2& box, int texture) {
-  image_shader.queue_viewport(flip_box(masks.top()), flip_box(box), texture);
+  batcher.queue_viewport(flip_box(masks.top()), flip_box(box), texture);
 }
 
-void GuiRenderer::begin(const Box2& viewport) {
+void GuiRenderer::queue_cached(const Box2& box, int texture) {
+  batcher.queue_cached(flip_box(masks.top()), flip_box(box), texture);
+}
+
+void GuiRenderer::begin(const Box2& viewport, bool keep_previous) {
+  // Recorded commands are flipped to the previous viewport
+  can_replay = keep_previous && viewport.lower == this->viewport.lower &&
+               viewport.upper == this->viewport.upper;
   this->viewport = viewport;
+  batcher.next_frame();
   if (masks.size() == 1) {
     masks.pop();
   }
@@ -70,18 +79,53 @@ void GuiRenderer::begin(const Box2& viewport) {
 void GuiRenderer::end() {
   assert(masks.size() == 1);
   masks.pop();
+
+  if (!can_replay) {
+    damage_ = viewport;
+    return;
+  }
+  Box2 flipped = batcher.damage();
+  if (flipped.empty()) {
+    damage_ = Box2();
+    return;
+  }
+  Box2 damage;
+  damage.lower.x = std::floor(viewport.lower.x + flipped.lower.x);
+  damage.lower.y = std::floor(viewport.upper.y - flipped.upper.y);
+  damage.upper.x = std::ceil(viewport.lower.x + flipped.upper.x);
+  damage.upper.y = std::ceil(viewport.upper.y - flipped.lower.y);
+  damage_ = intersection(damage, viewport);
+  if (damage_.empty()) {
+    damage_ = Box2();
+  }
 }
 
-void GuiRenderer::render() {
-  camera.position = viewport.center();
+void GuiRenderer::end_layer() {
+  batcher.end_layer();
+}
+
+void GuiRenderer::render(std::size_t layer) {
+  Box2 framebuffer(Vec2(), viewport.size());
+  camera.position = framebuffer.center();
   camera.angle = 0;
-  camera.size = viewport.size();
-  shape_shader.draw(viewport, camera);
-  text_shader.draw(viewport, camera);
-  image_shader.draw(viewport, camera);
-  shape_shader.clear();
-  text_shader.clear();
-  image_shader.clear();
+  camera.size = framebuffer.size();
+  batcher.draw(layer, framebuffer, camera, flip_box(damage_));
+}
+
+bool GuiRenderer::replay(
+    std::size_t frame,
+    std::size_t begin,
+    std::size_t end) {
+  return can_replay && batcher.replay(frame, begin, end);
+}
+
+bool GuiRenderer::replay_if_same(
+    std::size_t frame,
+    std::size_t begin,
+    std::size_t end,
+    std::size_t recorded_begin) {
+  return can_replay &&
+         batcher.replay_if_same(frame, begin, end, recorded_begin);
 }
 
 void GuiRenderer::push_mask(const Box2& mask) {
@@ -97,14 +141,16 @@ void GuiRenderer::pop_mask() {
 }
 
 Box2 GuiRenderer::flip_box(const Box2& box) {
-  Box2 result = box;
-  result.lower.y = viewport.size().y - box.upper.y;
-  result.upper.y = viewport.size().y - box.lower.y;
+  Box2 result;
+  result.lower.x = box.lower.x - viewport.lower.x;
+  result.upper.x = box.upper.x - viewport.lower.x;
+  result.lower.y = viewport.upper.y - box.upper.y;
+  result.upper.y = viewport.upper.y - box.lower.y;
   return result;
 }
 
 Vec2 GuiRenderer::flip_position(const Vec2& origin) {
-  return Vec2(origin.x, viewport.size().y - origin.y);
+  return Vec2(origin.x - viewport.lower.x, viewport.upper.y - origin.y);
 }
 
 } // namespace dgui
@@ -2,6 +2,7 @@
 #include "datagui/geometry/rot.hpp"
 #include "datagui/visual/shader_utils.hpp"
 #include <GL/glew.h>
+#include <cstring>
 #include <vector>
 
 namespace dgui {
@@ -35,7 +36,7 @@ void main(){
 }
 )";
 
-ImageShader::ImageShader() : program_id(0), uniform_PV(0), VAO(0), VBO(0) {}
+ImageShader::ImageShader() : program_id(0), uniform_PV(0), VAO(0) {}
 
 ImageShader::~ImageShader() {
   if (program_id > 0) {
@@ -44,20 +45,16 @@ ImageShader::~ImageShader() {
   if (VAO > 0) {
     glDeleteVertexArrays(1, &VAO);
   }
-  if (VBO > 0) {
-    glDeleteBuffers(1, &VBO);
-  }
 }
 
-ImageShader::ImageShader(ImageShader&& other) {
+ImageShader::ImageShader(ImageShader&& other) :
+    vertex_buffer(std::move(other.vertex_buffer)) {
   program_id = other.program_id;
   uniform_PV = other.uniform_PV;
   VAO = other.VAO;
-  VBO = other.VBO;
 
   other.program_id = 0;
   other.VAO = 0;
-  other.VBO = 0;
 }
 
 void ImageShader::init() {
@@ -65,10 +62,10 @@ void ImageShader::init() {
   uniform_PV = glGetUniformLocation(program_id, "PV");
 
   glGenVertexArrays(1, &VAO);
-  glGenBuffers(1, &VBO);
+  vertex_buffer.init();
 
   glBindVertexArray(VAO);
-  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer.id());
 
   glVertexAttribPointer(
       0,
@@ -192,9 +189,23 @@ void ImageShader::draw(const Box2& viewport, const Camera2d& camera) {
   glDisable(GL_CULL_FACE);
   glDisable(GL_DEPTH_TEST);
 
+  // Upload the vertices of every command together, then draw each command
+  // from its range of the buffer
+  std::size_t command_size = sizeof(Command::vertices);
+  auto vertices = static_cast<std::uint8_t*>(vertex_buffer.map(
+      commands.size() * command_size,
+      sizeof(Vertex),
+      stats_));
+  for (const auto& command : commands) {
+    std::memcpy(vertices, command.vertices.data(), command_size);
+    vertices += command_size;
+  }
+  vertex_buffer.unmap();
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  std::size_t first = vertex_buffer.offset() / sizeof(Vertex);
+
   glUseProgram(program_id);
   glBindVertexArray(VAO);
-  glBindBuffer(GL_ARRAY_BUFFER, VBO);
   glUniformMatrix3fv(uniform_PV, 1, GL_FALSE, PV.data);
 
   for (const auto& command : commands) {
@@ -204,17 +215,14 @@ void ImageShader::draw(const Box2& viewport, const Camera2d& camera) {
       assert(command.image.data->texture > 0);
       glBindTexture(GL_TEXTURE_2D, command.image.data->texture);
     }
-    glBufferData(
-        GL_ARRAY_BUFFER,
-        command.vertices.size() * sizeof(Vertex),
-        command.vertices.data(),
-        GL_STATIC_DRAW);
+    glDrawArrays(GL_TRIANGLES, first, command.vertices.size());
+    first += command.vertices.size();
 
-    glDrawArrays(GL_TRIANGLES, 0, command.vertices.size());
+    stats_.instances++;
+    stats_.draw_calls++;
   }
 
   glBindTexture(GL_TEXTURE_2D, 0);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
   glBindVertexArray(0);
   glUseProgram(0);
 }
@@ -108,7 +108,6 @@ void Shape2dShader::init() {
   // Generate ids
   glGenVertexArrays(1, &VAO);
   glGenBuffers(1, &static_VBO);
-  glGenBuffers(1, &instance_VBO);
 
   // Bind vertex array
   glBindVertexArray(VAO);
@@ -141,8 +140,15 @@ void Shape2dShader::init() {
 
   glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-  // Bind and configure buffer for indices
-  glBindBuffer(GL_ARRAY_BUFFER, instance_VBO);
+  // Per-instance attributes, which point into the range of the instance
+  // buffer written by each draw
+  instance_buffer.init();
+  set_instance_attributes(0);
+}
+
+void Shape2dShader::set_instance_attributes(std::size_t offset) {
+  glBindBuffer(GL_ARRAY_BUFFER, instance_buffer.id());
+  GLuint index = 1;
 
   for (std::size_t i = 0; i < 3; i++) {
     glVertexAttribPointer(
@@ -151,7 +157,7 @@ void Shape2dShader::init() {
         GL_FLOAT,
         GL_FALSE,
         sizeof(Element),
-        (void*)(offsetof(Element, M) + sizeof(float) * 3 * i));
+        (void*)(offset + offsetof(Element, M) + sizeof(float) * 3 * i));
     glVertexAttribDivisor(index, 1);
     glEnableVertexAttribArray(index);
     index++;
@@ -163,7 +169,7 @@ void Shape2dShader::init() {
       GL_FLOAT,
       GL_FALSE,
       sizeof(Element),
-      (void*)offsetof(Element, color));
+      (void*)(offset + offsetof(Element, color)));
   glVertexAttribDivisor(index, 1);
   glEnableVertexAttribArray(index);
   index++;
@@ -174,7 +180,7 @@ void Shape2dShader::init() {
       GL_FLOAT,
       GL_FALSE,
       sizeof(Element),
-      (void*)offsetof(Element, border_color));
+      (void*)(offset + offsetof(Element, border_color)));
   glVertexAttribDivisor(index, 1);
   glEnableVertexAttribArray(index);
   index++;
@@ -185,7 +191,7 @@ void Shape2dShader::init() {
       GL_FLOAT,
       GL_FALSE,
       sizeof(Element),
-      (void*)offsetof(Element, border_width));
+      (void*)(offset + offsetof(Element, border_width)));
   glVertexAttribDivisor(index, 1);
   glEnableVertexAttribArray(index);
   index++;
@@ -196,7 +202,7 @@ void Shape2dShader::init() {
       GL_FLOAT,
       GL_FALSE,
       sizeof(Element),
-      (void*)offsetof(Element, radius));
+      (void*)(offset + offsetof(Element, radius)));
   glVertexAttribDivisor(index, 1);
   glEnableVertexAttribArray(index);
   index++;
@@ -207,7 +213,7 @@ void Shape2dShader::init() {
       GL_FLOAT,
       GL_FALSE,
       sizeof(Element),
-      (void*)(offsetof(Element, mask) + offsetof(Box2, lower)));
+      (void*)(offset + offsetof(Element, mask) + offsetof(Box2, lower)));
   glVertexAttribDivisor(index, 1);
   glEnableVertexAttribArray(index);
   index++;
@@ -218,7 +224,7 @@ void Shape2dShader::init() {
       GL_FLOAT,
       GL_FALSE,
       sizeof(Element),
-      (void*)(offsetof(Element, mask) + offsetof(Box2, upper)));
+      (void*)(offset + offsetof(Element, mask) + offsetof(Box2, upper)));
   glVertexAttribDivisor(index, 1);
   glEnableVertexAttribArray(index);
   index++;
@@ -390,18 +396,20 @@ void Shape2dShader::draw(const Box2& viewport, const Camera2d& camera) {
   Mat3 P = camera.projection_mat();
   Mat3 PV = P * V;
 
-  glBindBuffer(GL_ARRAY_BUFFER, instance_VBO);
-  glBufferData(
-      GL_ARRAY_BUFFER,
-      elements.size() * sizeof(Element),
+  glBindVertexArray(VAO);
+  std::size_t offset = instance_buffer.write(
       elements.data(),
-      GL_STATIC_DRAW);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
+      elements.size() * sizeof(Element),
+      sizeof(Element),
+      stats_);
+  set_instance_attributes(offset);
 
   glUseProgram(program_id);
   glUniformMatrix3fv(uniform_PV, 1, GL_FALSE, PV.data);
-  glBindVertexArray(VAO);
   glDrawArraysInstanced(GL_TRIANGLES, 0, static_vertex_count, elements.size());
+
+  stats_.instances += elements.size();
+  stats_.draw_calls++;
 }
 
 void Shape2dShader::clear() {
@@ -0,0 +1,99 @@
+#include "datagui/visual/stream_buffer.hpp"
+#include <GL/glew.h>
+#include <assert.h>
+#include <cstring>
+
+namespace dgui {
+
+StreamBuffer::StreamBuffer(std::size_t initial_capacity) :
+    VBO(0),
+    capacity_(initial_capacity),
+    offset_(0),
+    size_(0),
+    end_(0),
+    using_fallback(false) {
+  assert(initial_capacity > 0);
+}
+
+StreamBuffer::~StreamBuffer() {
+  if (VBO > 0) {
+    glDeleteBuffers(1, &VBO);
+  }
+}
+
+StreamBuffer::StreamBuffer(StreamBuffer&& other) :
+    VBO(other.VBO),
+    capacity_(other.capacity_),
+    offset_(other.offset_),
+    size_(other.size_),
+    end_(other.end_),
+    fallback(std::move(other.fallback)),
+    using_fallback(other.using_fallback) {
+  other.VBO = 0;
+}
+
+void StreamBuffer::init() {
+  glGenBuffers(1, &VBO);
+  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  glBufferData(GL_ARRAY_BUFFER, capacity_, nullptr, GL_STREAM_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void* StreamBuffer::map(
+    std::size_t size,
+    std::size_t stride,
+    RenderStats& stats) {
+  assert(VBO > 0 && stride > 0);
+  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+  std::size_t offset = (end_ + stride - 1) / stride * stride;
+  if (offset + size > capacity_) {
+    // Orphan the storage, so the driver allocates new storage while the
+    // GPU finishes with the old
+    while (capacity_ < size) {
+      capacity_ *= 2;
+    }
+    glBufferData(GL_ARRAY_BUFFER, capacity_, nullptr, GL_STREAM_DRAW);
+    stats.buffer_allocations++;
+    offset = 0;
+  }
+  offset_ = offset;
+  size_ = size;
+  end_ = offset + size;
+  stats.bytes_uploaded += size;
+
+  // Nothing written to this storage overlaps the range, so no need to wait
+  // for the GPU
+  void* data = glMapBufferRange(
+      GL_ARRAY_BUFFER,
+      offset,
+      size,
+      GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+          GL_MAP_UNSYNCHRONIZED_BIT);
+  using_fallback = !data;
+  if (using_fallback) {
+    fallback.resize(size);
+    return fallback.data();
+  }
+  return data;
+}
+
+void StreamBuffer::unmap() {
+  if (using_fallback) {
+    glBufferSubData(GL_ARRAY_BUFFER, offset_, size_, fallback.data());
+    return;
+  }
+  glUnmapBuffer(GL_ARRAY_BUFFER);
+}
+
+std::size_t StreamBuffer::write(
+    const void* data,
+    std::size_t size,
+    std::size_t stride,
+    RenderStats& stats) {
+  std::memcpy(map(size, stride, stats), data, size);
+  unmap();
+  return offset_;
+}
+
+} // namespace dgui
@@ -1,7 +1,9 @@
 #include "datagui/visual/text_2d_shader.hpp"
 #include "datagui/visual/shader_utils.hpp"
 #include <GL/glew.h>
+#include <algorithm>
 #include <assert.h>
+#include <cmath>
 #include <string>
 
 namespace dgui {
@@ -9,16 +11,24 @@ namespace dgui {
 const static std::string vertex_shader = R"(
 #version 330 core
 
-layout(location = 0) in vec2 position;
-layout(location = 1) in vec2 uv;
+layout(location = 0) in vec2 corner;
+layout(location = 1) in vec2 position;
+layout(location = 2) in vec2 axis_x;
+layout(location = 3) in vec2 axis_y;
+layout(location = 4) in vec2 uv_lower;
+layout(location = 5) in vec2 uv_upper;
+layout(location = 6) in vec4 text_color;
 
 uniform mat3 PV;
 out vec2 fs_uv;
+flat out vec4 fs_text_color;
 
 void main(){
-  vec3 coords = PV * vec3(position, 1);
+  vec2 pos = position + corner.x * axis_x + corner.y * axis_y;
+  vec3 coords = PV * vec3(pos, 1);
   gl_Position = vec4(coords.xy / coords.z, 0, 1);
-  fs_uv = uv;
+  fs_uv = uv_lower * (1 - corner) + uv_upper * corner;
+  fs_text_color = text_color;
 }
 )";
 
@@ -26,58 +36,99 @@ const static std::string fragment_shader = R"(
 #version 330 core
 
 in vec2 fs_uv;
+flat in vec4 fs_text_color;
 
 uniform sampler2D tex;
-uniform vec4 text_color;
 
 out vec4 color;
 
 void main(){
-  color = vec4(text_color.xyz, texture(tex, fs_uv).x * text_color.a);
+  color = vec4(fs_text_color.xyz, texture(tex, fs_uv).x * fs_text_color.a);
 }
 )";
 
-void Text2dShader::init(const std::shared_ptr<FontManager>& fm) {
+static std::array<std::uint8_t, 4> pack_color(const Color& color) {
+  std::array<std::uint8_t, 4> result;
+  for (std::size_t i = 0; i < 4; i++) {
+    float value = std::clamp(color.data[i], 0.f, 1.f);
+    result[i] = std::lround(value * 255);
+  }
+  return result;
+}
+
+void Text2dShader::init(
+    const std::shared_ptr<FontManager>& fm,
+    const std::shared_ptr<FrameArena>& arena) {
   this->fm = fm;
+  this->arena = arena;
 
   // Configure shader program and buffers
 
   program_id = create_program(vertex_shader, fragment_shader);
   uniform_PV = glGetUniformLocation(program_id, "PV");
-  uniform_text_color = glGetUniformLocation(program_id, "text_color");
 
   glGenVertexArrays(1, &VAO);
-  glGenBuffers(1, &VBO);
+  glGenBuffers(1, &static_VBO);
 
   glBindVertexArray(VAO);
-  glBindBuffer(GL_ARRAY_BUFFER, VBO);
-
-  GLuint index = 0;
-
-  glVertexAttribPointer(
-      index,
-      2,
-      GL_FLOAT,
-      GL_FALSE,
-      sizeof(Vertex),
-      (void*)offsetof(Vertex, pos));
-  glEnableVertexAttribArray(index);
-  index++;
-
-  glVertexAttribPointer(
-      index,
-      2,
-      GL_FLOAT,
-      GL_FALSE,
-      sizeof(Vertex),
-      (void*)offsetof(Vertex, uv));
-  glEnableVertexAttribArray(index);
-  index++;
+
+  // Corners of the glyph quad
+  const std::vector<Vec2> static_vertices = {
+      Vec2(0, 0),
+      Vec2(1, 0),
+      Vec2(0, 1),
+      Vec2(1, 0),
+      Vec2(1, 1),
+      Vec2(0, 1)};
+  static_vertex_count = static_vertices.size();
+
+  glBindBuffer(GL_ARRAY_BUFFER, static_VBO);
+  glBufferData(
+      GL_ARRAY_BUFFER,
+      static_vertices.size() * sizeof(Vec2),
+      static_vertices.data(),
+      GL_STATIC_DRAW);
+
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vec2), (void*)0);
+  glEnableVertexAttribArray(0);
 
   glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  // Per-glyph attributes, which point into the range of the instance
+  // buffer written for each font texture
+  instance_buffer.init();
+  set_instance_attributes(0);
+
   glBindVertexArray(0);
 }
 
+void Text2dShader::set_instance_attributes(std::size_t offset) {
+  glBindBuffer(GL_ARRAY_BUFFER, instance_buffer.id());
+  GLuint index = 1;
+
+  auto attribute = [&](int size, GLenum type, std::size_t glyph_offset) {
+    glVertexAttribPointer(
+        index,
+        size,
+        type,
+        type == GL_UNSIGNED_BYTE ? GL_TRUE : GL_FALSE,
+        sizeof(Glyph),
+        (void*)(offset + glyph_offset));
+    glVertexAttribDivisor(index, 1);
+    glEnableVertexAttribArray(index);
+    index++;
+  };
+
+  attribute(2, GL_FLOAT, offsetof(Glyph, position));
+  attribute(2, GL_FLOAT, offsetof(Glyph, axis_x));
+  attribute(2, GL_FLOAT, offsetof(Glyph, axis_y));
+  attribute(2, GL_FLOAT, offsetof(Glyph, uv) + offsetof(Box2, lower));
+  attribute(2, GL_FLOAT, offsetof(Glyph, uv) + offsetof(Box2, upper));
+  attribute(4, GL_UNSIGNED_BYTE, offsetof(Glyph, color));
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
 void Text2dShader::queue_masked_text(
     const Box2& mask,
     const Vec2& origin,
@@ -87,8 +138,14 @@ void Text2dShader::queue_masked_text(
     Color text_color,
     Length width) {
 
-  auto characters = fm->text_characters(text, font, font_size, width);
-  auto& vertices = get_vertices(font, font_size, text_color);
+  auto characters = fm->text_characters(
+      text,
+      font,
+      font_size,
+      width,
+      arena ? arena.get() : std::pmr::get_default_resource());
+  auto& glyphs = get_glyphs(font, font_size);
+  auto color = pack_color(text_color);
 
   // Mutable reference to [box, uv] so they can be modified if necessary
   for (auto& [box, uv] : characters) {
@@ -116,12 +173,9 @@ void Text2dShader::queue_masked_text(
       box = new_box;
       uv = new_uv;
     }
-    vertices.push_back(Vertex{box.lower_left(), uv.lower_left()});
-    vertices.push_back(Vertex{box.lower_right(), uv.lower_right()});
-    vertices.push_back(Vertex{box.upper_left(), uv.upper_left()});
-    vertices.push_back(Vertex{box.lower_right(), uv.lower_right()});
-    vertices.push_back(Vertex{box.upper_right(), uv.upper_right()});
-    vertices.push_back(Vertex{box.upper_left(), uv.upper_left()});
+    Vec2 size = box.size();
+    glyphs.push_back(
+        Glyph{box.lower, Vec2(size.x, 0), Vec2(0, size.y), uv, color});
   }
 }
 
@@ -135,49 +189,49 @@ void Text2dShader::queue_text(
     Color text_color,
     Length width) {
 
-  auto characters = fm->text_characters(text, font, font_size, width);
-  auto& vertices = get_vertices(font, font_size, text_color);
+  auto characters = fm->text_characters(
+      text,
+      font,
+      font_size,
+      width,
+      arena ? arena.get() : std::pmr::get_default_resource());
+  auto& glyphs = get_glyphs(font, font_size);
+  auto color = pack_color(text_color);
 
+  Mat2 rot = Rot2(angle).mat();
   for (const auto& [box, uv] : characters) {
-    Mat2 rot = Rot2(angle).mat();
     Vec2 lower_left = origin + scale * (rot * box.lower_left());
     Vec2 lower_right = origin + scale * (rot * box.lower_right());
     Vec2 upper_left = origin + scale * (rot * box.upper_left());
-    Vec2 upper_right = origin + scale * (rot * box.upper_right());
-
-    vertices.push_back(Vertex{lower_left, uv.lower_left()});
-    vertices.push_back(Vertex{lower_right, uv.lower_right()});
-    vertices.push_back(Vertex{upper_left, uv.upper_left()});
-    vertices.push_back(Vertex{lower_right, uv.lower_right()});
-    vertices.push_back(Vertex{upper_right, uv.upper_right()});
-    vertices.push_back(Vertex{upper_left, uv.upper_left()});
+    glyphs.push_back(Glyph{
+        lower_left,
+        lower_right - lower_left,
+        upper_left - lower_left,
+        uv,
+        color});
   }
 }
 
-std::vector<Text2dShader::Vertex>& Text2dShader::get_vertices(
+std::vector<Text2dShader::Glyph>& Text2dShader::get_glyphs(
     Font font,
-    int font_size,
-    const Color& color) {
+    int font_size) {
   const auto& fs = fm->font_structure(font, font_size);
 
-  std::size_t char_list_i = 0;
-  while (char_list_i < char_lists.size()) {
-    const auto& char_list = char_lists[char_list_i];
-    if (char_list.font_texture == fs.font_texture &&
-        char_list.font_color.equals(color)) {
-      break;
+  // Only one list per font texture, so few to search
+  for (auto& glyph_list : glyph_lists) {
+    if (glyph_list.font_texture == fs.font_texture) {
+      return glyph_list.glyphs;
     }
-    char_list_i++;
-  }
-  if (char_list_i == char_lists.size()) {
-    return char_lists.emplace_back(fs.font_texture, color).vertices;
-  } else {
-    return char_lists[char_list_i].vertices;
   }
+  return glyph_lists.emplace_back(fs.font_texture).glyphs;
 }
 
 void Text2dShader::draw(const Box2& viewport, const Camera2d& camera) {
-  if (char_lists.empty()) {
+  std::size_t glyph_count = 0;
+  for (const auto& glyph_list : glyph_lists) {
+    glyph_count += glyph_list.glyphs.size();
+  }
+  if (glyph_count == 0) {
     return;
   }
   glViewport(
@@ -195,33 +249,43 @@ void Text2dShader::draw(const Box2& viewport, const Camera2d& camera) {
   Mat3 P = camera.projection_mat();
   Mat3 PV = P * V;
 
+  // Upload the glyphs of every list together, then draw each list from its
+  // range of the buffer
+  auto glyphs = static_cast<Glyph*>(
+      instance_buffer.map(glyph_count * sizeof(Glyph), sizeof(Glyph), stats_));
+  for (const auto& glyph_list : glyph_lists) {
+    glyphs = std::copy(
+        glyph_list.glyphs.begin(),
+        glyph_list.glyphs.end(),
+        glyphs);
+  }
+  instance_buffer.unmap();
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  std::size_t offset = instance_buffer.offset();
+
   glUseProgram(program_id);
   glBindVertexArray(VAO);
   glUniformMatrix3fv(uniform_PV, 1, GL_FALSE, PV.data);
 
-  for (const auto& char_list : char_lists) {
-    if (char_list.vertices.empty()) {
+  for (const auto& glyph_list : glyph_lists) {
+    if (glyph_list.glyphs.empty()) {
       continue;
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(
-        GL_ARRAY_BUFFER,
-        char_list.vertices.size() * sizeof(Vertex),
-        char_list.vertices.data(),
-        GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    glUniform4f(
-        uniform_text_color,
-        char_list.font_color.r,
-        char_list.font_color.g,
-        char_list.font_color.b,
-        char_list.font_color.a);
-
-    glBindTexture(GL_TEXTURE_2D, char_list.font_texture);
-    glDrawArrays(GL_TRIANGLES, 0, char_list.vertices.size());
+    // Instanced draws can't start from an instance offset in GL 3.3, so
+    // move the attributes instead
+    set_instance_attributes(offset);
+    glBindTexture(GL_TEXTURE_2D, glyph_list.font_texture);
+    glDrawArraysInstanced(
+        GL_TRIANGLES,
+        0,
+        static_vertex_count,
+        glyph_list.glyphs.size());
     glBindTexture(GL_TEXTURE_2D, 0);
+    offset += glyph_list.glyphs.size() * sizeof(Glyph);
+
+    stats_.instances += glyph_list.glyphs.size();
+    stats_.draw_calls++;
   }
 
   glBindVertexArray(0);
@@ -229,7 +293,7 @@ void Text2dShader::draw(const Box2& viewport, const Camera2d& camera) {
 }
 
 void Text2dShader::clear() {
-  char_lists.clear();
+  glyph_lists.clear();
 }
 
 } // namespace dgui
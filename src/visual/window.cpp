@@ -1,7 +1,9 @@
 #include "datagui/visual/window.hpp"
 
 #include <GLFW/glfw3.h>
+#include <algorithm>
 #include <assert.h>
+#include <cstdlib>
 #include <cstring>
 #include <mutex>
 #include <shared_mutex>
@@ -186,7 +188,12 @@ Window::Window() :
     default_width(900),
     default_height(600),
     window(nullptr),
-    size_(900, 600) {
+    size_(900, 600),
+    mode_(WindowMode::Visible),
+    offscreen_framebuffer(0),
+    offscreen_color(0),
+    offscreen_depth(0),
+    has_input_(false) {
   for (std::size_t i = 0; i < MouseButtonSize; i++) {
     mouse_button_down_[i] = false;
     mouse_down_mod_[i].ctrl = false;
@@ -205,11 +212,20 @@ bool Window::running() const {
 void Window::open(
     const std::string& title,
     std::size_t width,
-    std::size_t height) {
+    std::size_t height,
+    WindowMode mode) {
   this->title = title;
   default_width = width;
   default_height = height;
   size_ = Vec2(width, height);
+  mode_ = mode;
+
+  bool no_display = !std::getenv("DISPLAY") && !std::getenv("WAYLAND_DISPLAY");
+#ifdef GLFW_PLATFORM_NULL
+  if (mode == WindowMode::Headless && no_display) {
+    glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+  }
+#endif
 
   if (!glfwInit()) {
     throw std::runtime_error("Failed to initialize glfw");
@@ -221,6 +237,15 @@ void Window::open(
   glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
   glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 
+  if (mode == WindowMode::Headless) {
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#ifdef GLFW_PLATFORM_NULL
+    if (no_display) {
+      glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+    }
+#endif
+  }
+
   // Create window with graphics context
   window = glfwCreateWindow(
       default_width,
@@ -235,13 +260,31 @@ void Window::open(
 
   glfwMakeContextCurrent(window);
 
-  // Enable vsync
-  glfwSwapInterval(1);
+  // Enable vsync, unless headless where frames should run as fast as possible
+  glfwSwapInterval(mode == WindowMode::Headless ? 0 : 1);
 
-  if (glewInit() != GLEW_OK) {
+  GLenum glew_result = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+  // Expected for non-GLX contexts, where the functions still load
+  if (mode == WindowMode::Headless &&
+      glew_result == GLEW_ERROR_NO_GLX_DISPLAY) {
+    glew_result = GLEW_OK;
+  }
+#endif
+  if (glew_result != GLEW_OK) {
     throw std::runtime_error("Failed to initialise glew");
   }
 
+  if (mode == WindowMode::Visible) {
+    int display_w, display_h;
+    glfwGetFramebufferSize(window, &display_w, &display_h);
+    size_ = Vec2(display_w, display_h);
+  }
+  glGenFramebuffers(1, &offscreen_framebuffer);
+  glGenRenderbuffers(1, &offscreen_color);
+  glGenRenderbuffers(1, &offscreen_depth);
+  resize_offscreen();
+
   glfwSetMouseButtonCallback(window, glfw_mouse_button_callback);
   glfwSetScrollCallback(window, glfw_scroll_callback);
   glfwSetKeyCallback(window, glfw_key_callback);
@@ -268,52 +311,194 @@ void Window::close() {
   }
 
   glfwMakeContextCurrent(window);
+  if (offscreen_framebuffer > 0) {
+    glDeleteFramebuffers(1, &offscreen_framebuffer);
+    glDeleteRenderbuffers(1, &offscreen_color);
+    glDeleteRenderbuffers(1, &offscreen_depth);
+    offscreen_framebuffer = 0;
+    offscreen_color = 0;
+    offscreen_depth = 0;
+  }
   glfwDestroyWindow(window);
   glfwTerminate();
   window = nullptr;
 }
 
-void Window::render_begin() {
-  int display_w, display_h;
-  glfwGetFramebufferSize(window, &display_w, &display_h);
-  glViewport(0, 0, display_w, display_h);
-  size_ = Vec2(display_w, display_h);
+void Window::resize_offscreen() {
+  offscreen_size = size_;
+  glBindRenderbuffer(GL_RENDERBUFFER, offscreen_color);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, size_.x, size_.y);
+  glBindRenderbuffer(GL_RENDERBUFFER, offscreen_depth);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, size_.x, size_.y);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, offscreen_framebuffer);
+  glFramebufferRenderbuffer(
+      GL_FRAMEBUFFER,
+      GL_COLOR_ATTACHMENT0,
+      GL_RENDERBUFFER,
+      offscreen_color);
+  glFramebufferRenderbuffer(
+      GL_FRAMEBUFFER,
+      GL_DEPTH_STENCIL_ATTACHMENT,
+      GL_RENDERBUFFER,
+      offscreen_depth);
+  assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+}
+
+void Window::render_begin(bool clear) {
+  if (mode_ == WindowMode::Visible) {
+    int display_w, display_h;
+    glfwGetFramebufferSize(window, &display_w, &display_h);
+    // Zero while minimized, so keep the previous size
+    if (display_w > 0 && display_h > 0) {
+      size_ = Vec2(display_w, display_h);
+    }
+  }
+  if (size_ != offscreen_size) {
+    resize_offscreen();
+  }
+  glBindFramebuffer(GL_FRAMEBUFFER, offscreen_framebuffer);
+  glViewport(0, 0, size_.x, size_.y);
 
   glEnable(GL_BLEND);
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+  if (clear) {
+    glClearColor(1.f, 1.f, 1.f, 1.f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  }
+}
+
+void Window::clear(const Box2& region) {
+  if (region.empty()) {
+    return;
+  }
+  // Y up
+  glEnable(GL_SCISSOR_TEST);
+  glScissor(
+      region.lower.x,
+      size_.y - region.upper.y,
+      region.upper.x - region.lower.x,
+      region.upper.y - region.lower.y);
   glClearColor(1.f, 1.f, 1.f, 1.f);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  glDisable(GL_SCISSOR_TEST);
 }
 
 void Window::render_end() {
+  if (mode_ == WindowMode::Headless) {
+    // Nothing to present, but wait for the frame so it is included in timings
+    glFinish();
+    return;
+  }
+  // The back buffer isn't preserved across swaps, so the frame is kept in
+  // the offscreen framebuffer and copied over
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, offscreen_framebuffer);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+  glBlitFramebuffer(
+      0,
+      0,
+      size_.x,
+      size_.y,
+      0,
+      0,
+      size_.x,
+      size_.y,
+      GL_COLOR_BUFFER_BIT,
+      GL_NEAREST);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
   glfwSwapBuffers(window);
 }
 
 void Window::set_fixed_size(const Vec2& size) {
+  if (mode_ == WindowMode::Headless) {
+    if (size != size_) {
+      size_ = size;
+      resize_offscreen();
+    }
+    return;
+  }
   glfwSetWindowSize(window, size.x, size.y);
   glfwSetWindowAttrib(window, GLFW_RESIZABLE, false);
   size_ = size;
 }
 
 void Window::set_dynamic_size() {
+  if (mode_ == WindowMode::Headless) {
+    return;
+  }
   glfwSetWindowAttrib(window, GLFW_RESIZABLE, true);
 }
 
-void Window::poll_events() {
+void Window::set_vsync(bool enabled) {
+  if (mode_ == WindowMode::Headless) {
+    return;
+  }
+  glfwSwapInterval(enabled ? 1 : 0);
+}
+
+void Window::clear_events() {
   mouse_events_.clear();
   scroll_events_.clear();
   key_events_.clear();
   text_events_.clear();
-  glfwPollEvents();
 
+  if (mode_ == WindowMode::Headless) {
+    std::swap(mouse_events_, injected_mouse_events);
+    std::swap(scroll_events_, injected_scroll_events);
+    std::swap(key_events_, injected_key_events);
+    std::swap(text_events_, injected_text_events);
+  }
+}
+
+void Window::poll_events() {
+  clear_events();
+  if (mode_ != WindowMode::Headless) {
+    glfwPollEvents();
+  }
+  process_events();
+}
+
+void Window::wait_events(double timeout) {
+  clear_events();
+  // Headless input only arrives through injection, so never block
+  if (mode_ != WindowMode::Headless) {
+    glfwWaitEventsTimeout(timeout);
+  }
+  process_events();
+}
+
+void Window::wake() {
+  glfwPostEmptyEvent();
+}
+
+void Window::process_events() {
   Modifiers mod;
-  mod.ctrl = glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS;
-  mod.shift = glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS;
+  Vec2 prev_mouse_pos = mouse_pos_;
+  int display_w, display_h;
 
-  double mx, my;
-  glfwGetCursorPos(window, &mx, &my);
-  mouse_pos_ = Vec2(mx, my);
+  if (mode_ == WindowMode::Headless) {
+    mod = injected_mod;
+    mouse_pos_ = injected_mouse_pos;
+    display_w = size_.x;
+    display_h = size_.y;
+  } else {
+    mod.ctrl = glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS;
+    mod.shift = glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS;
+
+    double mx, my;
+    glfwGetCursorPos(window, &mx, &my);
+    mouse_pos_ = Vec2(mx, my);
+
+    glfwGetFramebufferSize(window, &display_w, &display_h);
+  }
+
+  // Checked before adding hold events, which are generated every poll
+  has_input_ = !mouse_events_.empty() || !scroll_events_.empty() ||
+               !key_events_.empty() || !text_events_.empty() ||
+               mouse_pos_ != prev_mouse_pos ||
+               Vec2(display_w, display_h) != size_;
 
   for (auto& event : mouse_events_) {
     if (event.action == MouseAction::Press) {
@@ -363,4 +548,100 @@ void Window::poll_events() {
   }
 }
 
+void Window::inject_mouse_pos(const Vec2& mouse_pos) {
+  injected_mouse_pos = mouse_pos;
+}
+
+void Window::inject_mouse_button(MouseButton button, MouseAction action) {
+  assert(action != MouseAction::Hold);
+  std::size_t i = (std::size_t)button;
+
+  MouseEvent event;
+  event.button = button;
+  event.action = action;
+  event.position = injected_mouse_pos;
+  if (action == MouseAction::Press) {
+    mouse_button_down_[i] = true;
+    mouse_down_position_[i] = injected_mouse_pos;
+    event.press_position = injected_mouse_pos;
+  } else {
+    mouse_button_down_[i] = false;
+    event.press_position = mouse_down_position_[i];
+  }
+  injected_mouse_events.push_back(event);
+}
+
+void Window::inject_scroll(float amount) {
+  ScrollEvent event;
+  event.amount = amount;
+  injected_scroll_events.push_back(event);
+}
+
+void Window::inject_key(Key key, KeyAction action) {
+  KeyEvent event;
+  event.key = key;
+  event.action = action;
+  event.mod = injected_mod;
+  event.glfw_window = (void*)window;
+  injected_key_events.push_back(event);
+}
+
+void Window::inject_text(char value) {
+  TextEvent event;
+  event.value = value;
+  injected_text_events.push_back(event);
+}
+
+void Window::inject_modifiers(const Modifiers& mod) {
+  injected_mod = mod;
+}
+
+InputFrame Window::input() const {
+  InputFrame input;
+  input.mouse_pos = mouse_pos_;
+  input.mouse_events = mouse_events_;
+  input.scroll_events = scroll_events_;
+  input.key_events = key_events_;
+  input.text_events = text_events_;
+  return input;
+}
+
+void Window::replay_input(const InputFrame& input) {
+  has_input_ = !input.empty() || input.mouse_pos != mouse_pos_;
+  mouse_pos_ = input.mouse_pos;
+  mouse_events_ = input.mouse_events;
+  scroll_events_ = input.scroll_events;
+  key_events_ = input.key_events;
+  text_events_ = input.text_events;
+  for (auto& event : key_events_) {
+    event.glfw_window = (void*)window;
+  }
+}
+
+void Window::request_close() {
+  if (window) {
+    glfwSetWindowShouldClose(window, true);
+  }
+}
+
+std::vector<std::uint8_t> Window::read_pixels() const {
+  std::size_t width = size_.x;
+  std::size_t height = size_.y;
+  std::vector<std::uint8_t> pixels(width * height * 4);
+
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, offscreen_framebuffer);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+  // OpenGL rows are bottom first
+  std::size_t row_size = width * 4;
+  for (std::size_t i = 0; i < height / 2; i++) {
+    std::swap_ranges(
+        pixels.begin() + i * row_size,
+        pixels.begin() + (i + 1) * row_size,
+        pixels.begin() + (height - 1 - i) * row_size);
+  }
+  return pixels;
+}
+
 } // namespace dgui
@@ -0,0 +1,162 @@
+#include "datagui/element/hit_grid.hpp"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace dgui;
+
+// Reference: Walk the tree, as done without the grid
+static ElementPtr walk_tree(ElementPtr root, const Vec2& position) {
+  ElementPtr leaf;
+  std::vector<ElementPtr> stack = {root};
+  while (!stack.empty()) {
+    auto element = stack.back();
+    stack.pop_back();
+    const auto& state = element.state();
+    if (state.hidden) {
+      continue;
+    }
+    bool contains = !state.float_only && state.box().contains(position);
+    if (state.floating) {
+      contains |= element.cold_state().float_box.contains(position);
+    }
+    if (!contains) {
+      continue;
+    }
+    leaf = element;
+    for (auto child = element.child(); child; child = child.next()) {
+      stack.push_back(child);
+    }
+  }
+  return leaf;
+}
+
+static void set_box(ElementPtr element, const Box2& box) {
+  element.state().position = box.lower;
+  element.state().size = box.size();
+}
+
+TEST(HitGrid, FindLeaf) {
+  Tree tree;
+  auto root = tree.root();
+  root.create(Type::Group);
+  set_box(root, Box2(Vec2(0, 0), Vec2(200, 100)));
+
+  // Overlapping children, so the first is found
+  auto a = root.child();
+  a.create(Type::Group);
+  set_box(a, Box2(Vec2(0, 0), Vec2(100, 100)));
+  auto b = a.next();
+  b.create(Type::Button);
+  set_box(b, Box2(Vec2(50, 0), Vec2(200, 100)));
+
+  // Child outside its parent, so can't be hit
+  auto c = a.child();
+  c.create(Type::Button);
+  set_box(c, Box2(Vec2(150, 0), Vec2(200, 50)));
+
+  HitGrid grid(32);
+  grid.build(root, Box2(Vec2(0, 0), Vec2(200, 100)));
+  EXPECT_TRUE(*grid.find(root, Vec2(75, 50)) == a);
+  EXPECT_TRUE(*grid.find(root, Vec2(150, 50)) == b);
+  EXPECT_TRUE(*grid.find(root, Vec2(175, 25)) == b);
+  EXPECT_FALSE(grid.find(root, Vec2(250, 50)).has_value());
+
+  // Hidden elements and their children are skipped
+  a.state().hidden = true;
+  grid.build(root, Box2(Vec2(0, 0), Vec2(200, 100)));
+  EXPECT_TRUE(*grid.find(root, Vec2(75, 50)) == b);
+  EXPECT_TRUE(*grid.find(root, Vec2(25, 50)) == root);
+}
+
+TEST(HitGrid, Floating) {
+  Tree tree;
+  auto root = tree.root();
+  root.create(Type::Group);
+  set_box(root, Box2(Vec2(0, 0), Vec2(200, 100)));
+  root.state().contains_floating = true;
+
+  // Parent is outside the bounds, but the floating child can still be found
+  // from itself
+  auto a = root.child();
+  a.create(Type::Group);
+  set_box(a, Box2(Vec2(300, 0), Vec2(400, 100)));
+  a.state().contains_floating = true;
+  auto b = a.child();
+  b.create(Type::Dropdown);
+  set_box(b, Box2(Vec2(300, 0), Vec2(400, 20)));
+  b.state().floating = true;
+  b.state().contains_floating = true;
+  b.cold_state().float_box = Box2(Vec2(0, 0), Vec2(100, 100));
+
+  HitGrid grid(32);
+  grid.build(root, Box2(Vec2(0, 0), Vec2(200, 100)));
+  EXPECT_TRUE(*grid.find(b, Vec2(50, 50)) == b);
+  EXPECT_FALSE(*grid.find(b, Vec2(150, 50)));
+  EXPECT_TRUE(*grid.find(root, Vec2(50, 50)) == root);
+}
+
+TEST(HitGrid, MatchesTreeWalk) {
+  std::mt19937 rng(0);
+  auto random_box = [&](const Box2& parent) {
+    std::uniform_real_distribution<float> dist(-0.2, 1.2);
+    Vec2 size = parent.size();
+    Vec2 p1 = parent.lower + Vec2(dist(rng) * size.x, dist(rng) * size.y);
+    Vec2 p2 = parent.lower + Vec2(dist(rng) * size.x, dist(rng) * size.y);
+    return Box2(minimum(p1, p2), maximum(p1, p2));
+  };
+
+  Tree tree;
+  auto root = tree.root();
+  root.create(Type::Group);
+  set_box(root, Box2(Vec2(0, 0), Vec2(500, 400)));
+
+  std::vector<ElementPtr> elements = {root};
+  std::vector<ElementPtr> floating;
+  for (std::size_t i = 0; i < 500; i++) {
+    auto parent = elements[rng() % elements.size()];
+    auto element = parent.child();
+    while (element) {
+      element = element.next();
+    }
+    element.create(Type::Group);
+    set_box(element, random_box(parent.state().box()));
+    auto& state = element.state();
+    state.hidden = rng() % 20 == 0;
+    state.floating = rng() % 10 == 0;
+    state.float_only = state.floating && rng() % 2 == 0;
+    if (state.floating) {
+      element.cold_state().float_box = random_box(root.state().box());
+      for (auto iter = element; iter; iter = iter.parent()) {
+        iter.state().contains_floating = true;
+      }
+    }
+    elements.push_back(element);
+  }
+
+  // Floating elements which aren't hidden, which are searched from
+  for (auto element : elements) {
+    if (!element.state().floating) {
+      continue;
+    }
+    bool hidden = false;
+    for (auto iter = element; iter; iter = iter.parent()) {
+      hidden |= iter.state().hidden;
+    }
+    if (!hidden) {
+      floating.push_back(element);
+    }
+  }
+
+  HitGrid grid(32);
+  grid.build(root, root.state().box());
+  std::uniform_real_distribution<float> x_dist(0, 500);
+  std::uniform_real_distribution<float> y_dist(0, 400);
+  for (std::size_t i = 0; i < 2000; i++) {
+    Vec2 position(x_dist(rng), y_dist(rng));
+    EXPECT_TRUE(*grid.find(root, position) == walk_tree(root, position));
+    for (auto element : floating) {
+      EXPECT_TRUE(
+          *grid.find(element, position) == walk_tree(element, position));
+    }
+  }
+}
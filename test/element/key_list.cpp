@@ -0,0 +1,93 @@
+#include "datagui/element/key_list.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <thread>
+#include <unordered_set>
+
+TEST(KeyList, AppendInsertRemove) {
+  using namespace dgui;
+
+  KeyList keys;
+  std::size_t a = keys.append();
+  std::size_t b = keys.append();
+  std::size_t c = keys.insert(1);
+  EXPECT_NE(a, 0);
+
+  ASSERT_EQ(keys.size(), 3);
+  EXPECT_EQ(keys[0], a);
+  EXPECT_EQ(keys[1], c);
+  EXPECT_EQ(keys[2], b);
+  EXPECT_EQ(keys.index(b), 2);
+
+  keys.remove(a);
+  ASSERT_EQ(keys.size(), 2);
+  EXPECT_FALSE(keys.contains(a));
+  EXPECT_EQ(keys[0], c);
+  EXPECT_EQ(keys[1], b);
+  EXPECT_EQ(keys.index(b), 1);
+
+  EXPECT_THROW(keys.remove(a), std::runtime_error);
+  EXPECT_THROW(keys.insert(3), std::out_of_range);
+}
+
+TEST(KeyList, MatchesVector) {
+  using namespace dgui;
+
+  KeyList keys;
+  std::vector<std::size_t> expected;
+  std::mt19937 gen(0);
+
+  for (std::size_t i = 0; i < 5000; i++) {
+    if (expected.empty() || gen() % 3 != 0) {
+      std::size_t pos = gen() % (expected.size() + 1);
+      std::size_t key = keys.insert(pos);
+      expected.insert(expected.begin() + pos, key);
+    } else {
+      std::size_t pos = gen() % expected.size();
+      keys.remove(expected[pos]);
+      expected.erase(expected.begin() + pos);
+    }
+  }
+
+  ASSERT_EQ(keys.size(), expected.size());
+  for (std::size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(keys[i], expected[i]);
+    EXPECT_EQ(keys.index(expected[i]), i);
+  }
+  std::vector<std::size_t> iterated(keys.begin(), keys.end());
+  EXPECT_EQ(iterated, expected);
+
+  KeyList copy = keys;
+  while (copy.size() > 0) {
+    copy.remove(copy[copy.size() / 2]);
+  }
+  EXPECT_EQ(copy.begin(), copy.end());
+  EXPECT_EQ(keys.size(), expected.size());
+}
+
+TEST(KeyList, UniqueKeysAcrossThreads) {
+  using namespace dgui;
+
+  const std::size_t n = 1000;
+  std::vector<KeyList> lists(4);
+  std::vector<std::thread> threads;
+  for (auto& list : lists) {
+    threads.emplace_back([&list]() {
+      for (std::size_t i = 0; i < n; i++) {
+        list.append();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::unordered_set<std::size_t> keys;
+  for (const auto& list : lists) {
+    for (std::size_t key : list) {
+      keys.insert(key);
+    }
+  }
+  EXPECT_EQ(keys.size(), lists.size() * n);
+}
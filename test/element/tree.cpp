@@ -42,3 +42,288 @@ TEST(Tree, CreateElements) {
     text_input.text = "hello";
   }
 }
+
+TEST(Tree, StaleElementPtr) {
+  using namespace dgui;
+
+  Tree tree;
+  auto root = tree.root();
+  root.create(Type::Group);
+
+  auto a = root.child();
+  a.create(Type::Button);
+  ElementPtr held = a;
+  ASSERT_TRUE(held);
+
+  // Remove the element, then create another which reuses its slot
+  a.erase();
+  EXPECT_FALSE(held);
+
+  auto b = root.child();
+  b.create(Type::TextBox);
+  ASSERT_TRUE(b);
+  EXPECT_FALSE(held);
+  EXPECT_FALSE(held == b);
+}
+
+TEST(Tree, KeyedReorder) {
+  using namespace dgui;
+
+  Tree tree;
+  auto root = tree.root();
+  root.create(Type::Group);
+
+  auto build = [&](const std::vector<std::size_t>& ids) {
+    std::vector<ElementPtr> result;
+    auto element = root.child();
+    for (std::size_t id : ids) {
+      if (element.expect(Type::TextInput, id)) {
+        element.text_input().text = std::to_string(id);
+        element.var().create<std::size_t>(id);
+      }
+      result.push_back(element);
+      element = element.next();
+    }
+    element.expect_end();
+    return result;
+  };
+
+  auto first = build({1, 2, 3, 4});
+  auto second = build({4, 1, 5, 3, 2});
+  ASSERT_EQ(second.size(), 5);
+
+  // Existing elements are moved rather than recreated
+  EXPECT_TRUE(second[0] == first[3]);
+  EXPECT_TRUE(second[1] == first[0]);
+  EXPECT_TRUE(second[3] == first[2]);
+  EXPECT_TRUE(second[4] == first[1]);
+  for (auto element : first) {
+    EXPECT_TRUE(element);
+  }
+
+  // Order, state and variables follow the new order
+  std::vector<std::size_t> expected = {4, 1, 5, 3, 2};
+  auto element = root.child();
+  for (std::size_t id : expected) {
+    ASSERT_TRUE(element);
+    EXPECT_EQ(element.id(), id);
+    EXPECT_EQ(element.text_input().text, std::to_string(id));
+    EXPECT_EQ(*element.var().as<std::size_t>(), id);
+    element = element.next();
+  }
+  EXPECT_FALSE(element);
+
+  // Check the reverse links
+  element = root.last_child();
+  for (auto iter = expected.rbegin(); iter != expected.rend(); iter++) {
+    ASSERT_TRUE(element);
+    EXPECT_EQ(element.id(), *iter);
+    element = element.prev();
+  }
+  EXPECT_FALSE(element);
+
+  // Elements not expected are removed
+  auto third = build({3, 4});
+  EXPECT_TRUE(third[0] == first[2]);
+  EXPECT_TRUE(third[1] == first[3]);
+  EXPECT_FALSE(first[0]);
+  EXPECT_FALSE(first[1]);
+  EXPECT_FALSE(second[2]);
+  EXPECT_EQ(root.child().size(), 2);
+}
+
+TEST(Tree, Compact) {
+  using namespace dgui;
+
+  Tree tree;
+  auto root = tree.root();
+  root.create(Type::Group);
+
+  std::size_t N = 200;
+  auto element = root.child();
+  for (std::size_t i = 0; i < N; i++) {
+    element.expect(Type::TextInput, i + 1);
+    element.text_input().text = std::to_string(i);
+    element.var().create<std::size_t>(i);
+    element.state().num_cells = i;
+    element.cold_state().float_priority = i;
+    element = element.next();
+  }
+
+  // Remove most elements, holding handles to one kept and one removed
+  ElementPtr kept;
+  ElementPtr removed;
+  element = root.child();
+  for (std::size_t i = 0; i < N; i++) {
+    if (i == 150) {
+      kept = element;
+    }
+    if (i % 10 == 0) {
+      element = element.next();
+      continue;
+    }
+    if (i == 151) {
+      removed = element;
+    }
+    element = element.erase();
+  }
+  EXPECT_FALSE(removed);
+
+  ASSERT_TRUE(tree.compact());
+  tree.remap(root);
+  tree.remap(kept);
+  tree.remap(removed);
+  ASSERT_TRUE(kept);
+  EXPECT_EQ(kept.text_input().text, "150");
+  EXPECT_EQ(kept.id(), 151);
+  EXPECT_FALSE(removed);
+
+  // Links, state, props and variables are remapped
+  std::size_t i = 0;
+  element = root.child();
+  while (element) {
+    EXPECT_EQ(element.text_input().text, std::to_string(i));
+    EXPECT_EQ(*element.var().as<std::size_t>(), i);
+    EXPECT_EQ(element.state().num_cells, i);
+    EXPECT_EQ(element.cold_state().float_priority, i);
+    EXPECT_TRUE(element.parent() == root);
+    element = element.next();
+    i += 10;
+  }
+  EXPECT_EQ(i, N);
+
+  // Keyed lookup still works
+  element = root.child();
+  EXPECT_FALSE(element.expect(Type::TextInput, 101));
+  EXPECT_EQ(element.text_input().text, "100");
+  EXPECT_EQ(root.child().next().id(), 1);
+
+  // Not compacted again while occupancy is high
+  EXPECT_FALSE(tree.compact());
+}
+
+TEST(Tree, DirtyPropagation) {
+  using namespace dgui;
+
+  Tree tree;
+  auto root = tree.root();
+  root.create(Type::Group);
+  auto group = root.child();
+  group.create(Type::Group);
+  auto text_box = group.child();
+  text_box.create(Type::TextBox);
+  auto other = group.next();
+  other.create(Type::TextBox, 1);
+
+  auto clear_dirty = [&]() {
+    for (auto element : {root, group, text_box, other}) {
+      if (element) {
+        element.state().dirty = false;
+      }
+    }
+  };
+
+  // Created elements and their ancestors are dirty
+  EXPECT_TRUE(root.state().dirty);
+  EXPECT_TRUE(group.state().dirty);
+  EXPECT_TRUE(text_box.state().dirty);
+  EXPECT_TRUE(other.state().dirty);
+
+  // Propagates to ancestors only
+  clear_dirty();
+  text_box.set_dirty();
+  EXPECT_TRUE(text_box.state().dirty);
+  EXPECT_TRUE(group.state().dirty);
+  EXPECT_TRUE(root.state().dirty);
+  EXPECT_FALSE(other.state().dirty);
+
+  // Moving a keyed element marks the parent
+  clear_dirty();
+  auto first = root.child();
+  ASSERT_FALSE(first.expect(Type::TextBox, 1));
+  EXPECT_TRUE(root.state().dirty);
+  EXPECT_FALSE(group.state().dirty);
+  EXPECT_FALSE(other.state().dirty);
+
+  // Removing children marks the element
+  clear_dirty();
+  group.clear();
+  EXPECT_TRUE(group.state().dirty);
+  EXPECT_TRUE(root.state().dirty);
+  EXPECT_FALSE(other.state().dirty);
+  text_box = ElementPtr();
+
+  // Removing an element marks the parent
+  clear_dirty();
+  other.erase();
+  EXPECT_TRUE(root.state().dirty);
+  EXPECT_FALSE(group.state().dirty);
+  other = ElementPtr();
+
+  // A hidden element is left dirty by the layout, so stops propagation until
+  // it is marked again
+  clear_dirty();
+  group.state().dirty = true;
+  auto child = group.child();
+  child.create(Type::TextBox);
+  EXPECT_FALSE(root.state().dirty);
+  group.set_dirty();
+  EXPECT_TRUE(root.state().dirty);
+
+  // Marking an element leaves the tree modified, so it is redrawn
+  tree.clear_modified();
+  group.set_dirty();
+  EXPECT_TRUE(tree.modified());
+}
+
+TEST(Tree, RenderDirtyPropagation) {
+  using namespace dgui;
+
+  Tree tree;
+  auto root = tree.root();
+  root.create(Type::Group);
+  auto group = root.child();
+  group.create(Type::Group);
+  auto text_box = group.child();
+  text_box.create(Type::TextBox);
+  auto other = group.next();
+  other.create(Type::TextBox, 1);
+
+  auto clear_dirty = [&]() {
+    for (auto element : {root, group, text_box, other}) {
+      element.state().dirty = false;
+      element.cold_state().render_dirty = false;
+      element.cold_state().subtree_render_dirty = false;
+    }
+  };
+
+  // Created elements and their ancestors are marked
+  EXPECT_TRUE(root.cold_state().subtree_render_dirty);
+  EXPECT_TRUE(group.cold_state().subtree_render_dirty);
+  EXPECT_TRUE(text_box.cold_state().subtree_render_dirty);
+
+  // Only the element is render dirty, but the subtree flag propagates to
+  // ancestors
+  clear_dirty();
+  text_box.set_render_dirty();
+  EXPECT_TRUE(text_box.cold_state().render_dirty);
+  EXPECT_FALSE(group.cold_state().render_dirty);
+  EXPECT_FALSE(root.cold_state().render_dirty);
+  EXPECT_TRUE(group.cold_state().subtree_render_dirty);
+  EXPECT_TRUE(root.cold_state().subtree_render_dirty);
+  EXPECT_FALSE(other.cold_state().subtree_render_dirty);
+
+  // Marking for layout marks for rendering too
+  clear_dirty();
+  other.set_dirty();
+  EXPECT_TRUE(other.cold_state().render_dirty);
+  EXPECT_TRUE(root.cold_state().subtree_render_dirty);
+  EXPECT_FALSE(group.cold_state().subtree_render_dirty);
+
+  // Stops at an ancestor which is already marked
+  clear_dirty();
+  group.cold_state().subtree_render_dirty = true;
+  text_box.set_render_dirty();
+  EXPECT_TRUE(group.cold_state().subtree_render_dirty);
+  EXPECT_FALSE(root.cold_state().subtree_render_dirty);
+}
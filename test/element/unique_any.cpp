@@ -12,3 +12,36 @@ TEST(UniqueAny, Construct) {
   EXPECT_EQ(*value.cast<std::string>(), "hello");
   EXPECT_FALSE(value.cast<int>());
 }
+
+TEST(UniqueAny, MoveAndDestroy) {
+  using namespace dgui;
+
+  struct Counter {
+    int* count;
+    Counter(int* count) : count(count) {
+      (*count)++;
+    }
+    ~Counter() {
+      (*count)--;
+    }
+  };
+
+  int count = 0;
+  {
+    UniqueAny a = UniqueAny::Make<Counter>(&count);
+    EXPECT_EQ(count, 1);
+    Counter* ptr = a.cast<Counter>();
+    ASSERT_TRUE(ptr);
+
+    UniqueAny b(std::move(a));
+    EXPECT_FALSE(a);
+    EXPECT_FALSE(a.cast<Counter>());
+    EXPECT_EQ(b.cast<Counter>(), ptr);
+    EXPECT_EQ(count, 1);
+
+    b = UniqueAny::Make<Counter>(&count);
+    EXPECT_EQ(count, 1);
+    EXPECT_NE(b.cast<Counter>(), nullptr);
+  }
+  EXPECT_EQ(count, 0);
+}
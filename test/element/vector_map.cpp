@@ -43,3 +43,62 @@ TEST(VectorMap, String) {
     }
   }
 }
+
+TEST(VectorMap, Generation) {
+  using namespace dgui;
+
+  VectorMap<int> map;
+  int a = map.emplace(1);
+  auto generation = map.generation(a);
+  EXPECT_TRUE(map.contains(a, generation));
+
+  map.pop(a);
+  int b = map.emplace(2);
+  ASSERT_EQ(a, b);
+  EXPECT_TRUE(map.contains(b));
+  EXPECT_FALSE(map.contains(a, generation));
+  EXPECT_TRUE(map.contains(b, map.generation(b)));
+}
+
+TEST(VectorMap, Compact) {
+  using namespace dgui;
+
+  VectorMap<std::string> map;
+  std::size_t N = 1000;
+  for (std::size_t i = 0; i < N; i++) {
+    map.emplace(std::to_string(i));
+  }
+  for (std::size_t i = 0; i < N; i++) {
+    if (i % 3 != 0) {
+      map.pop(i);
+    }
+  }
+  auto generation = map.generation(3);
+
+  auto remap = map.compact();
+  ASSERT_EQ(remap.size(), N);
+  EXPECT_EQ(map.size(), (N + 2) / 3);
+  EXPECT_EQ(map.slots(), map.size());
+  EXPECT_FALSE(map.contains(3, generation));
+
+  for (std::size_t i = 0; i < N; i++) {
+    if (i % 3 != 0) {
+      EXPECT_EQ(remap[i], -1);
+      continue;
+    }
+    ASSERT_EQ(remap[i], i / 3);
+    ASSERT_TRUE(map.contains(remap[i]));
+    EXPECT_EQ(map[remap[i]], std::to_string(i));
+  }
+
+  std::size_t count = 0;
+  for (const auto& value : map) {
+    EXPECT_EQ(value, std::to_string(count * 3));
+    count++;
+  }
+  EXPECT_EQ(count, map.size());
+
+  // New values are appended after the compacted values
+  int index = map.emplace("new");
+  EXPECT_EQ(index, map.size() - 1);
+}
@@ -0,0 +1,89 @@
+#include <datagui/gui.hpp>
+#include <gtest/gtest.h>
+#include <optional>
+#include <random>
+
+using namespace dgui;
+
+// Random nested groups of text, where some text changes each frame, so
+// subtrees of different sizes are measured again
+static void build_scene(Gui& gui, std::mt19937& gen, int depth) {
+  std::uniform_int_distribution<int> count(1, 6);
+  std::uniform_int_distribution<int> kind(0, 3);
+  std::uniform_int_distribution<int> length(0, 24);
+  std::uniform_int_distribution<int> letter('a', 'z');
+
+  int n = count(gen);
+  for (int i = 0; i < n; i++) {
+    int k = depth < 4 ? kind(gen) : kind(gen) % 2;
+    // Elements can't change type without a key
+    gui.key(i * 4 + k + 1);
+    if (k == 0) {
+      std::string text(length(gen), ' ');
+      for (auto& c : text) {
+        c = letter(gen);
+      }
+      gui.text_box(text);
+    } else if (k == 1) {
+      std::ignore = gui.button("Button " + std::to_string(length(gen)));
+    } else {
+      if (k == 3) {
+        gui.args().horizontal();
+      }
+      gui.group();
+      DGUI_SCOPE(gui);
+      build_scene(gui, gen, depth + 1);
+    }
+  }
+}
+
+// Hash of the window contents after each frame, or nullopt if a headless
+// window can't be opened
+static std::optional<std::vector<std::uint64_t>> run_scene(
+    std::size_t threads,
+    unsigned int seed,
+    std::size_t frames) {
+  Gui gui;
+  try {
+    gui.open("test", 900, 600, WindowMode::Headless);
+  } catch (const std::runtime_error&) {
+    return std::nullopt;
+  }
+  // Measure every subtree in parallel, however small
+  gui.parallel_layout(threads, 1);
+
+  std::vector<std::uint64_t> hashes;
+  for (std::size_t frame = 0; frame < frames; frame++) {
+    if (!gui.poll()) {
+      break;
+    }
+    if (frame > 0) {
+      std::uint64_t hash = 1469598103934665603ull;
+      for (auto byte : gui.window().read_pixels()) {
+        hash = (hash ^ byte) * 1099511628211ull;
+      }
+      hashes.push_back(hash);
+    }
+
+    // Some frames rebuild the same scene, so only part of it changes
+    std::mt19937 gen(seed * 1000 + frame / 3);
+    gui.group();
+    DGUI_SCOPE(gui);
+    gui.text_box("Frame " + std::to_string(frame));
+    build_scene(gui, gen, 0);
+  }
+  return hashes;
+}
+
+TEST(ParallelLayout, MatchesSequential) {
+  const std::size_t frames = 30;
+  for (unsigned int seed = 1; seed <= 5; seed++) {
+    auto sequential = run_scene(1, seed, frames);
+    auto parallel = run_scene(4, seed, frames);
+    if (!sequential || !parallel) {
+      GTEST_SKIP() << "Failed to open headless window";
+    }
+    ASSERT_EQ(sequential->size(), frames - 1);
+    EXPECT_EQ(*sequential, *parallel) << "Seed " << seed;
+  }
+}
@@ -0,0 +1,127 @@
+#include "datagui/input/input_recording.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+
+TEST(InputRecording, SkipsFramesWithoutInput) {
+  using namespace dgui;
+
+  InputRecording recording;
+  InputFrame input;
+  recording.push(input);
+
+  input.mouse_pos = Vec2(10, 20);
+  recording.push(input);
+  recording.push(input);
+
+  input.text_events.push_back(TextEvent{'a'});
+  recording.push(input);
+
+  EXPECT_EQ(recording.frame_count(), 4);
+  ASSERT_EQ(recording.frames().size(), 2);
+  EXPECT_EQ(recording.frames()[0].frame, 1);
+  EXPECT_EQ(recording.frames()[1].frame, 3);
+}
+
+TEST(InputRecording, WriteRead) {
+  using namespace dgui;
+
+  InputRecording recording;
+  for (std::size_t i = 0; i < 300; i++) {
+    InputFrame input;
+    input.mouse_pos = Vec2(i / 10, 5);
+
+    if (i % 7 == 0) {
+      MouseEvent event;
+      event.button = MouseButton::Right;
+      event.action = MouseAction::Hold;
+      event.position = Vec2(i, 2);
+      event.press_position = Vec2(1, 2);
+      event.mod.shift = true;
+      event.is_double_click = i % 2 == 0;
+      input.mouse_events.push_back(event);
+    }
+    if (i % 11 == 0) {
+      ScrollEvent event;
+      event.position = Vec2(3, 4);
+      event.amount = -50;
+      event.mod.ctrl = true;
+      input.scroll_events.push_back(event);
+    }
+    if (i % 13 == 0) {
+      KeyEvent event;
+      event.key = Key::Z;
+      event.action = KeyAction::Repeat;
+      event.mod.ctrl = true;
+      input.key_events.push_back(event);
+      input.text_events.push_back(TextEvent{char(i)});
+    }
+    recording.push(input);
+  }
+
+  std::stringstream ss;
+  recording.write(ss);
+
+  InputRecording result;
+  result.read(ss);
+
+  ASSERT_EQ(result.frame_count(), recording.frame_count());
+  ASSERT_EQ(result.frames().size(), recording.frames().size());
+  for (std::size_t i = 0; i < result.frames().size(); i++) {
+    const auto& a = recording.frames()[i];
+    const auto& b = result.frames()[i];
+    EXPECT_EQ(a.frame, b.frame);
+    EXPECT_EQ(a.mouse_pos, b.mouse_pos);
+
+    ASSERT_EQ(a.mouse_events.size(), b.mouse_events.size());
+    for (std::size_t j = 0; j < a.mouse_events.size(); j++) {
+      EXPECT_EQ(a.mouse_events[j].button, b.mouse_events[j].button);
+      EXPECT_EQ(a.mouse_events[j].action, b.mouse_events[j].action);
+      EXPECT_EQ(a.mouse_events[j].position, b.mouse_events[j].position);
+      EXPECT_EQ(
+          a.mouse_events[j].press_position,
+          b.mouse_events[j].press_position);
+      EXPECT_EQ(a.mouse_events[j].mod.shift, b.mouse_events[j].mod.shift);
+      EXPECT_EQ(
+          a.mouse_events[j].is_double_click,
+          b.mouse_events[j].is_double_click);
+    }
+
+    ASSERT_EQ(a.scroll_events.size(), b.scroll_events.size());
+    for (std::size_t j = 0; j < a.scroll_events.size(); j++) {
+      EXPECT_EQ(a.scroll_events[j].position, b.scroll_events[j].position);
+      EXPECT_EQ(a.scroll_events[j].amount, b.scroll_events[j].amount);
+      EXPECT_EQ(a.scroll_events[j].mod.ctrl, b.scroll_events[j].mod.ctrl);
+    }
+
+    ASSERT_EQ(a.key_events.size(), b.key_events.size());
+    for (std::size_t j = 0; j < a.key_events.size(); j++) {
+      EXPECT_EQ(a.key_events[j].key, b.key_events[j].key);
+      EXPECT_EQ(a.key_events[j].action, b.key_events[j].action);
+      EXPECT_EQ(a.key_events[j].mod.ctrl, b.key_events[j].mod.ctrl);
+    }
+
+    ASSERT_EQ(a.text_events.size(), b.text_events.size());
+    for (std::size_t j = 0; j < a.text_events.size(); j++) {
+      EXPECT_EQ(a.text_events[j].value, b.text_events[j].value);
+    }
+  }
+}
+
+TEST(InputRecording, InvalidData) {
+  using namespace dgui;
+
+  InputRecording recording;
+  std::stringstream ss("not a recording");
+  EXPECT_THROW(recording.read(ss), std::runtime_error);
+
+  InputFrame input;
+  input.text_events.push_back(TextEvent{'a'});
+  recording.push(input);
+  std::stringstream valid;
+  recording.write(valid);
+
+  std::string truncated = valid.str();
+  truncated.pop_back();
+  std::stringstream ss_truncated(truncated);
+  EXPECT_THROW(recording.read(ss_truncated), std::runtime_error);
+}